@@ -1,19 +1,34 @@
 #ifndef ARENA_H_INC
 #define ARENA_H_INC
 
+#include <mutex>
+#include <atomic>
+#include <cstring>
+
 #include "base.hpp"
 
 // ArenaChunk represents a single chunk of contiguous memory used by the arena.
-// The chunks double as a singly linked list. 
+// Each chunk is a large range of reserved virtual memory whose pages are only
+// committed as the allocation pointer reaches them, so an arena almost always
+// has only one chunk.  The chunks double as a singly linked list. 
 struct ArenaChunk {
     // n_used is the number of bytes actually in use.  Coincidentally, it
     // points to the next free address in the chunk's memory buffer.
     size_t n_used;
 
-    // n_alloc is the number of bytes allocated and ready for use.
+    // n_alloc is the number of bytes committed and ready for use.
     size_t n_alloc;
 
-    // prev is the previous chunk in the linked list.
+    // n_reserve is the number of bytes reserved for the chunk's buffer.  The
+    // buffer can grow up to this size without moving.
+    size_t n_reserve;
+
+    // huge_pages indicates whether the chunk has been marked to use
+    // transparent huge pages.
+    bool huge_pages;
+
+    // prev is the previous chunk in the linked list.  This comes last so that
+    // the buffer stays aligned.
     ArenaChunk* prev;
 
     // data is the "named pointer" to the memory buffer: the buffer starts after
@@ -21,25 +36,114 @@ struct ArenaChunk {
     byte data[0];
 };
 
+// ArenaTag indicates what an arena is used for.  Arena statistics are reported
+// by tag.
+enum ArenaTag {
+    ARENA_UNTAGGED,
+    ARENA_GLOBAL,   // Symbols, types, and other data which lives for the whole build
+    ARENA_AST,      // AST nodes (released once their module is checked)
+    ARENA_CHECK,    // Checker symbols, types, HIR declarations, and comptime values
+    ARENA_HIR,      // HIR statements and expressions (released once their module is generated)
+
+    ARENA_TAGS_COUNT
+};
+
+// ArenaStats is the memory accounting of an arena.  Apart from the peak, all
+// the statistics describe the memory currently held by the arena: they are
+// cleared when the arena is reset or released.
+struct ArenaStats {
+    // n_requested is the number of bytes requested by allocations.  For
+    // concurrent arenas, this is counted as blocks are handed out to threads
+    // so it includes the unused ends of the threads' blocks.
+    size_t n_requested;
+
+    // n_align_waste is the number of bytes lost to aligning allocations.  This
+    // is not tracked for concurrent arenas.
+    size_t n_align_waste;
+
+    // n_tail_waste is the number of bytes left unused at the end of chunks
+    // which were too full for an allocation.
+    size_t n_tail_waste;
+
+    // n_chunks is the number of chunks held by the arena.
+    size_t n_chunks;
+
+    // n_reserved is the number of bytes of system memory committed by the
+    // arena including the chunk headers.  Reserved address space which has not
+    // been committed is not counted.
+    size_t n_reserved;
+
+    // peak_reserved is the largest value n_reserved has had.
+    size_t peak_reserved;
+
+    // Add adds the statistics of other to these statistics.  The peaks are
+    // summed: this gives an upper bound on the peak of the combined arenas.
+    void Add(const ArenaStats& other);
+};
+
+// ArenaMark is a saved allocation position in an arena which the arena can be
+// rewound to.  It also saves the arena's allocation statistics so that they can
+// be restored.
+struct ArenaMark {
+    ArenaChunk* chunk;
+    size_t n_used;
+
+    size_t n_requested;
+    size_t n_align_waste;
+    size_t n_tail_waste;
+};
+
+template<class T>
+class ArenaList;
+
+struct ArenaBlockCache;
+
 // Arena represents a "simple" linear memory chunk in which items are allocated
 // in sequence and never individually freed or resized after their creation has
 // completed.  Instead, once the objects in the arena are no longer needed, the
 // entire arena is disposed of at once.  This is useful for large pools objects
 // which have no clear owner and share the same extended lifetime such as types
 // or symbols.  
+//
+// A concurrent arena can be allocated in by many threads at once.  Each thread
+// bump allocates from its own block of the arena, and blocks are claimed from
+// the current chunk with a single atomic add: only committing more memory or
+// starting a new chunk requires a lock.  Resetting or releasing a concurrent
+// arena must still only be done once all the threads using it are done.
 // See: https://www.rfleury.com/p/untangling-lifetimes-the-arena-allocator
 class Arena {
     // curr_chunk points the "head" of the linked list of chunks.  Note that
     // this list is stored in reverse order.
     ArenaChunk* curr_chunk;
 
+    // tag indicates what the arena is used for.
+    ArenaTag tag;
+
+    // stats is the memory accounting of the arena.
+    ArenaStats stats;
+
+    // concurrent indicates whether the arena can be used by many threads.
+    bool concurrent;
+
+    // cache_id identifies the arena's current contents in the threads' block
+    // caches.  It is unique to the arena and changes whenever the arena is
+    // reset or released so that threads don't reuse their old blocks.
+    uint64_t cache_id;
+
+    // mutex guards committing memory and adding chunks in concurrent arenas.
+    std::mutex mutex;
+
     // System memory bindings.
-    void* sysAlloc(void* start, size_t size);
-    bool sysFree(void* block);
+    void* sysReserve(size_t size);
+    bool sysCommit(void* start, size_t size);
+    bool sysFree(void* block, size_t size);
+    void sysAdviseHugePages(void* start, size_t size);
+    size_t sysGetAddressSpaceLimit();
 
 public:
-    // Creates a new empty arena.
-    Arena() : curr_chunk(nullptr) {}
+    // Creates a new empty arena.  If concurrent is true, the arena can be
+    // allocated in by multiple threads at once.
+    Arena(ArenaTag tag = ARENA_UNTAGGED, bool concurrent = false);
 
     // Deletes the arena and frees all associated resources.
     ~Arena();
@@ -53,16 +157,46 @@ public:
     /* ---------------------------------------------------------------------- */
 
     // Alloc allocates size bytes in the arena.  The bytes will always be
-    // contiguous. If the allocation cannot be performed, NULL is returned.
+    // contiguous.  If the system is out of memory, the compiler aborts.
     void* Alloc(size_t size);
 
     // Reset resets the arena allocation pointer back to the start of the arena
-    // and releases all but the first chunk.
+    // and releases all but the first chunk.  The committed memory of the first
+    // chunk is kept for reuse.
     void Reset();
 
     // Release releases all the memory associated with the arena back to the OS.
     void Release();
 
+    // GetTag returns the arena's tag.
+    inline ArenaTag GetTag() const { return tag; }
+
+    // GetStats returns the arena's memory accounting.
+    inline const ArenaStats& GetStats() const { return stats; }
+
+    // IsConcurrent returns whether the arena can be used by many threads.
+    inline bool IsConcurrent() const { return concurrent; }
+
+    // Contains returns whether ptr points into memory reserved by the arena.
+    bool Contains(const void* ptr) const;
+
+    /* ---------------------------------------------------------------------- */
+
+    // Mark returns the current allocation position of the arena.  This can't
+    // be used on concurrent arenas.
+    ArenaMark Mark() const;
+
+    // Rewind frees everything allocated in the arena since mark was taken.
+    // Marks must be rewound to in the reverse order they were taken.  The
+    // committed memory is kept for reuse.
+    void Rewind(const ArenaMark& mark);
+
+    // TryExtend tries to grow the allocation at ptr from old_size bytes to
+    // new_size bytes in place.  This only succeeds if ptr is the last
+    // allocation made in the arena (by the current thread for concurrent
+    // arenas) and the arena has room for it after ptr.
+    bool TryExtend(void* ptr, size_t old_size, size_t new_size);
+
     /* ---------------------------------------------------------------------- */
 
     // New makes a new object of type T in the arena's storage passing args
@@ -86,13 +220,26 @@ public:
         size_t size = len * sizeof(char);
 
         char* data = (char*)Alloc(size);
-        memcpy_s(data, size, str.data(), size);
+        memcpy(data, str.data(), size);
 
         str.clear();
 
         return { data, len };
     }
 
+    // CopyStr copies the contents of str into the arena and returns a string
+    // view (slice) to the newly allocated memory.
+    inline std::string_view CopyStr(std::string_view str) {
+        if (str.size() == 0) {
+            return {};
+        }
+
+        char* data = (char*)Alloc(str.size() * sizeof(char));
+        memcpy(data, str.data(), str.size() * sizeof(char));
+
+        return { data, str.size() };
+    }
+
     // MoveVec moves the elements of vec into the arena and returns a span
     // (slice) to the newly allocated memory.  This deletes the memory
     // associated with vec but does perform a copy to move the memory from vec
@@ -106,9 +253,11 @@ public:
         size_t len = vec.size();
         size_t size = len * sizeof(T);
 
+        // The elements are constructed in place: assigning to the uninitialized
+        // memory would be undefined for types like std::string.
         T* data = (T*)Alloc(size);
-        for (int i = 0; i < len; i++) {
-            *(data + i) = std::move(vec[i]);
+        for (size_t i = 0; i < len; i++) {
+            std::construct_at(data + i, std::move(vec[i]));
         }
 
         vec.clear();
@@ -116,6 +265,12 @@ public:
         return { data, len };
     }
 
+    // MoveList moves the elements of list into the arena and returns a span
+    // (slice) to the newly allocated memory.  This is used to keep lists built
+    // in a scratch arena.  list is left empty.
+    template<class T>
+    inline std::span<T> MoveList(ArenaList<T>& list);
+
 private:
     // computeFwdOffset computes the amount to offset the start of a new block
     // of memory so that user memory starts at a properly aligned address.
@@ -123,6 +278,208 @@ private:
 
     // alignSize aligns the size so that it is a multiple of the arena alignment.
     size_t alignSize(size_t size);
+
+    // alignCommitSize aligns the size so that it is a multiple of the commit
+    // granularity.
+    size_t alignCommitSize(size_t size);
+
+    // findBlockCache returns the current thread's block cache for the arena
+    // or nullptr if the thread has no block in it.
+    ArenaBlockCache* findBlockCache();
+
+    // allocConcurrent allocates size bytes from the current thread's block of
+    // a concurrent arena.
+    void* allocConcurrent(size_t size);
+
+    // allocShared claims size bytes from the current chunk of a concurrent
+    // arena: this is used to allocate blocks and large objects.
+    void* allocShared(size_t size);
+
+    // newChunk reserves a new chunk which can hold at least min_size bytes and
+    // makes it the current chunk.  It returns false if the memory can't be
+    // reserved even after falling back to smaller reservations.
+    bool newChunk(size_t min_size);
+
+    // commitChunk commits enough of chunk for it to hold at least min_size
+    // bytes.
+    bool commitChunk(ArenaChunk* chunk, size_t min_size);
+
+    // freeChunk returns chunk to the OS and removes it from the statistics.
+    void freeChunk(ArenaChunk* chunk);
+};
+
+/* -------------------------------------------------------------------------- */
+
+// ArenaList is a growable list whose elements are stored in an arena: it is
+// used in place of a std::vector for lists which end up in an arena anyway.
+// The list grows in place while it is the last allocation in its arena and
+// otherwise moves to a larger buffer, leaving the old one to be freed with
+// the arena.  Like all arena data, the elements are never destroyed.
+template<class T>
+class ArenaList {
+    // arena is the arena the elements are stored in.
+    Arena& arena;
+
+    // data points to the list's buffer.
+    T* data;
+
+    // len is the number of elements in the list.
+    size_t len;
+
+    // cap is the number of elements the buffer can hold.
+    size_t cap;
+
+public:
+    // Creates a new empty list in arena with room for init_cap elements.
+    ArenaList(Arena& arena, size_t init_cap = 0)
+    : arena(arena)
+    , data(nullptr)
+    , len(0)
+    , cap(0)
+    {
+        if (init_cap > 0) {
+            data = (T*)arena.Alloc(init_cap * sizeof(T));
+            cap = init_cap;
+        }
+    }
+
+    // Lists hold a reference to their arena so they can't be copied.
+    ArenaList(const ArenaList&) = delete;
+
+    // Push adds elem to the end of the list.
+    inline void Push(T elem) {
+        if (len == cap) {
+            grow();
+        }
+
+        std::construct_at(data + len, std::move(elem));
+        len++;
+    }
+
+    // Emplace constructs a new element at the end of the list passing args to
+    // the constructor of T, and returns a reference to it.
+    template<class... Args>
+    inline T& Emplace(Args&&... args) {
+        if (len == cap) {
+            grow();
+        }
+
+        std::construct_at(data + len, std::forward<Args>(args)...);
+        return data[len++];
+    }
+
+    // Pop removes the last element of the list.
+    inline void Pop() {
+        len--;
+    }
+
+    // Len returns the number of elements in the list.
+    inline size_t Len() const { return len; }
+
+    // IsEmpty returns whether the list has no elements.
+    inline bool IsEmpty() const { return len == 0; }
+
+    // Back returns the last element of the list.
+    inline T& Back() { return data[len - 1]; }
+
+    inline T& operator[](size_t i) { return data[i]; }
+    inline T* begin() { return data; }
+    inline T* end() { return data + len; }
+
+    // Freeze returns a span of the list's elements in place: the span lives
+    // as long as the list's arena.  The list is left empty.
+    inline std::span<T> Freeze() {
+        std::span<T> elems { data, len };
+
+        data = nullptr;
+        len = 0;
+        cap = 0;
+
+        return elems;
+    }
+
+private:
+    // grow enlarges the list's buffer so it can hold at least one more element.
+    void grow() {
+        size_t new_cap = cap == 0 ? 4 : cap * 2;
+        if (data != nullptr && arena.TryExtend(data, cap * sizeof(T), new_cap * sizeof(T))) {
+            cap = new_cap;
+            return;
+        }
+
+        T* new_data = (T*)arena.Alloc(new_cap * sizeof(T));
+        for (size_t i = 0; i < len; i++) {
+            std::construct_at(new_data + i, std::move(data[i]));
+        }
+
+        data = new_data;
+        cap = new_cap;
+    }
 };
 
+template<class T>
+inline std::span<T> Arena::MoveList(ArenaList<T>& list) {
+    if (list.IsEmpty()) {
+        list.Freeze();
+        return {};
+    }
+
+    size_t len = list.Len();
+    T* data = (T*)Alloc(len * sizeof(T));
+    for (size_t i = 0; i < len; i++) {
+        std::construct_at(data + i, std::move(list[i]));
+    }
+
+    list.Freeze();
+    return { data, len };
+}
+
+/* -------------------------------------------------------------------------- */
+
+// GetScratchArena returns the current thread's scratch arena.  It holds
+// temporary data which is only needed for the duration of a ScratchScope.
+Arena& GetScratchArena();
+
+// ScratchScope marks the current thread's scratch arena when it is created and
+// rewinds it to the mark when it is destroyed: everything allocated in the
+// scratch arena during the scope is freed at the end of it.  Scopes nest.
+class ScratchScope {
+    Arena& arena;
+    ArenaMark mark;
+
+public:
+    ScratchScope()
+    : arena(GetScratchArena())
+    , mark(arena.Mark())
+    {}
+
+    ~ScratchScope() {
+        arena.Rewind(mark);
+    }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    // Get returns the scratch arena.
+    inline Arena& Get() { return arena; }
+};
+
+/* -------------------------------------------------------------------------- */
+
+// ArenaReport collects the statistics of arenas by tag.
+class ArenaReport {
+    ArenaStats tag_stats[ARENA_TAGS_COUNT] {};
+
+public:
+    // Add adds the statistics of arena to the report.
+    void Add(const Arena& arena);
+
+    // Print prints the report for the compilation phase named phase.
+    void Print(const char* phase);
+};
+
+// GetArenaPeakReserved returns the largest amount of system memory held by all
+// arenas at once over the life of the process.
+size_t GetArenaPeakReserved();
+
 #endif
\ No newline at end of file
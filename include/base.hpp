@@ -104,6 +104,42 @@ inline void ReportCompileError(
 // ErrorCount returns the number of errors that have been reported.
 int ErrorCount();
 
+// ResetErrorCount resets the number of errors reported to zero.  This is used
+// to reuse the process for multiple compilations.
+void ResetErrorCount();
+
+// DiagnosticBuffer stores the diagnostics reported by a task running on a
+// worker thread so that they can be displayed in a deterministic order once
+// all the tasks are done.
+struct DiagnosticBuffer {
+    // text is the formatted diagnostic output.
+    std::string text;
+
+    // Flush writes the buffered diagnostics to the console and clears them.
+    void Flush();
+};
+
+// CaptureDiagnostics redirects all diagnostics reported on the current thread
+// into a diagnostic buffer for as long as it is in scope.
+class CaptureDiagnostics {
+    DiagnosticBuffer* prev_buff;
+
+public:
+    CaptureDiagnostics(DiagnosticBuffer& buff);
+    ~CaptureDiagnostics();
+};
+
+// CaptureProcessDiagnostics redirects the diagnostics reported on every thread
+// which isn't capturing its own diagnostics into a diagnostic buffer for as
+// long as it is in scope.  The compile server uses this to send all of the
+// diagnostics of a build, including those of its worker threads, back to the
+// client.  Only one can be in scope at a time.
+class CaptureProcessDiagnostics {
+public:
+    CaptureProcessDiagnostics(DiagnosticBuffer& buff);
+    ~CaptureProcessDiagnostics();
+};
+
 /* -------------------------------------------------------------------------- */
 
 // GColor enumerates the colors used for three-color DFS cycle detection.
@@ -0,0 +1,38 @@
+#ifndef BUILD_CACHE_H_INC
+#define BUILD_CACHE_H_INC
+
+#include "base.hpp"
+
+// BuildCache is a persistent, content-addressed store for the object files
+// generated for modules.  Each object is stored under a key derived from all
+// the inputs which determine its contents: when a module is rebuilt with the
+// same key, its cached object can be reused instead of generating it again.
+// The cache is only an optimization: if it can't be read or written, modules
+// are simply compiled from scratch.
+class BuildCache {
+    // cache_dir is the directory the cached objects are stored in.
+    std::string cache_dir;
+
+    // enabled indicates whether the cache directory is usable.
+    bool enabled { false };
+
+public:
+    BuildCache(const std::string& cache_dir);
+
+    // Open creates the cache directory if it doesn't already exist.  The cache
+    // is disabled if the directory can't be created.
+    void Open();
+
+    // GetObjectPath returns the path to the object stored under key.  ext is
+    // the file extension of the object (including the leading dot).
+    std::string GetObjectPath(const std::string& key, const std::string& ext) const;
+
+    // Contains returns whether an object is stored under key.
+    bool Contains(const std::string& key, const std::string& ext) const;
+
+    // Store copies the object file at obj_path into the cache under key.  This
+    // is safe to call concurrently for different keys.
+    void Store(const std::string& key, const std::string& ext, const std::string& obj_path);
+};
+
+#endif
@@ -5,8 +5,20 @@
 #include "ast.hpp"
 #include "hir.hpp"
 
-// Scope represents a local lexical scope.
-typedef std::unordered_map<std::string_view, Symbol*> Scope;
+// LOCAL_NONE marks the end of a chain of local declarations.
+#define LOCAL_NONE SIZE_MAX
+
+// LocalEntry is a local symbol declared in an enclosing scope.
+struct LocalEntry {
+    Symbol* symbol;
+
+    // depth is the number of enclosing scopes of the declaration.
+    size_t depth;
+
+    // prev is the index of the declaration of the same name this one shadows
+    // or LOCAL_NONE if there is none.
+    size_t prev;
+};
 
 // NullSpan represents an occurrence of a null literal in an expression.
 struct NullSpan {
@@ -16,9 +28,14 @@ struct NullSpan {
 
 // Checker performs semantic analysis on a source file.
 class Checker {
-    // arena is the arena used for allocation of symbols and types.
+    // arena is the arena used for allocation of symbols, types, and HIR
+    // declarations.
     Arena& arena;
 
+    // hir_arena is the arena used for allocation of HIR statements and
+    // expressions.  It is the module's HIR arena.
+    Arena& hir_arena;
+
     // mod is the module being checked.
     Module& mod;
 
@@ -55,11 +72,38 @@ class Checker {
     // functions) to perform init order checking.
     std::vector<std::unordered_set<size_t>> init_graph;
 
+    /* ---------------------- Parallel Body Checking ------------------------ */
+
+    // n_body_workers is the number of workers used to check function bodies.
+    // If it is 1, function bodies are checked sequentially.
+    size_t n_body_workers { 1 };
+
+    // parent is the checker which forked this checker to check a single
+    // function body.  This is nullptr for the checker of a module.
+    Checker* parent { nullptr };
+
+    // A body task can't write to the shared init graph or dependency usages
+    // while other tasks are running, so it records its init graph edges and
+    // usages here to be merged by its parent once all the tasks are done.
+    std::vector<size_t> body_init_edges;
+    std::vector<std::pair<Module::DepEntry*, size_t>> body_usages;
+
     /* ---------------- Local Variables and Scoped Quantities --------------- */
 
-     // scope_stack keeps a stack of the enclosing local scopes with the one on
-    // the top (end) being the current local scope.
-    std::vector<Scope> scope_stack;
+    // locals is a flat stack of the local symbols of all the enclosing local
+    // scopes with the innermost declarations on the top (end).
+    std::vector<LocalEntry> locals;
+
+    // local_heads maps each local name to the index in locals of its innermost
+    // declaration (or LOCAL_NONE if it is not declared in any enclosing scope).
+    // The declarations of a name are chained through their prev indices so
+    // that lookups and declarations don't have to scan locals.
+    NameMap<size_t> local_heads;
+
+    // scope_starts stores the index in locals at which each enclosing local
+    // scope starts with the current local scope on the top (end).  Pushing and
+    // popping a scope just pushes and pops its start.
+    std::vector<size_t> scope_starts;
 
     // enclosing_return_type is the return type of the function whose body is
     // being type checked. If the checker is running outside of a function body,
@@ -119,14 +163,65 @@ class Checker {
     // pattern_ctx_stack is the stack of pattern contexts.
     std::vector<PatternContext> pattern_ctx_stack;
 
+    /* -------------------------- Foreign Bindings -------------------------- */
+
+    // ForeignBinding is a method or factory bound to a type defined in another
+    // module.  Exactly one of method and factory will be non-null.
+    struct ForeignBinding {
+        Type* bind_type;
+        Method* method;
+        FactoryFunc* factory;
+
+        size_t file_num;
+        TextSpan span;
+    };
+
+    // Modules are checked concurrently, so methods and factories bound to a
+    // type defined in another module can't be added to that type while other
+    // checkers may be reading it.  Instead, they are recorded in
+    // foreign_bindings and added to their types by MergeForeignBindings once
+    // every module being checked alongside this one is done.
+    std::vector<ForeignBinding> foreign_bindings;
+
+    // foreign_mtables and foreign_factories make the module's foreign bindings
+    // visible within the module itself until they are merged.
+    std::unordered_map<Type*, MethodTable> foreign_mtables;
+    std::unordered_map<Type*, FactoryFunc*> foreign_factories;
+
 public:
-    // Creates a new checker for src_file allocating in arena.
+    // Creates a new checker for mod allocating in arena and in the module's
+    // HIR arena.
     Checker(Arena& arena, Module& mod);
 
+    // EnableParallelBodies makes the checker check the function bodies of its
+    // module concurrently using n_workers workers (including the calling
+    // thread).  If n_workers is 1, the bodies are still checked sequentially.
+    // Each body is checked by its own task with its own type context and scope
+    // stack: all the tasks allocate in the checker's arenas which must be
+    // concurrent arenas.
+    void EnableParallelBodies(size_t n_workers);
+
     // CheckModule performs semantic analysis on the checker's module.
     void CheckModule();
 
+    // MergeForeignBindings adds the methods and factories the module binds to
+    // types defined in other modules to those types.  This must only be called
+    // when no other modules are being checked.
+    void MergeForeignBindings();
+
 private:
+    // Creates a new body task checker forked from parent allocating in arena
+    // and in the parent's HIR arena.
+    Checker(Arena& arena, Checker& parent);
+
+    void checkDeclBody(Decl* decl);
+    void checkBodiesParallel();
+
+    void addInitEdge(size_t decl_num);
+    void addDepUsage(Module::DepEntry& dep, size_t decl_num);
+
+    /* ---------------------------------------------------------------------- */
+
     bool addToInitOrder(Decl* decl);
     void reportCycle(Decl* decl);
 
@@ -137,8 +232,10 @@ private:
     HirDecl* checkFuncDecl(Decl* decl);
     HirDecl* checkMethodDecl(Decl* decl);
     HirDecl* checkFactoryDecl(Decl* decl);
-    Type* checkFuncSignature(AstNode* node, std::vector<Symbol*>& params);
+    Type* checkFuncSignature(AstNode* node, std::span<Symbol*>& params);
     MethodTable& getMethodTable(Type* bind_type);
+    Method* findMethod(Type* bind_type, std::string_view method_name);
+    FactoryFunc* findFactory(Type* bind_type);
 
     HirDecl* checkGlobalVar(Decl* decl);
     HirDecl* checkGlobalConst(Decl* decl);
@@ -8,6 +8,9 @@
 
 #include "hir.hpp"
 
+// MainBuilder builds the main module: the module containing the runtime entry
+// point which calls each module's init function and then the user's main
+// function.  The main module is generated in its own LLVM context.
 class MainBuilder {
     llvm::LLVMContext& ctx;
     llvm::Module& main_mod;
@@ -18,9 +21,13 @@ class MainBuilder {
 
 public:
     MainBuilder(llvm::LLVMContext& ctx, llvm::Module& main_mod);
-    void GenInitCall(llvm::Function* init_func);
+    void GenInitCall(Module& bry_mod);
     void GenUserMainCall(Module& root_mod);
     void FinishMain();
+
+    // ExportUserMain makes the user's main function in the root module's LLVM
+    // module externally visible so that it can be called by the main module.
+    static void ExportUserMain(Module& root_mod, llvm::Module& root_ll_mod);
 };
 
 
@@ -111,12 +118,6 @@ class CodeGenerator {
     // src_file is the source file whose definition is being processed.
     SourceFile* src_file;
 
-    // mainb is the main builder for the compilation task.
-    MainBuilder& mainb;
-
-    // arena is the arena used by the code generator.
-    Arena& arena;
-
     /* ---------------------------------------------------------------------- */
 
     // ll_enclosing_func is the enclosing LLVM function.
@@ -187,18 +188,42 @@ class CodeGenerator {
     // the dependency ID and the second index is the definition number.
     std::vector<std::unordered_map<size_t, llvm::Value*>> loaded_imports;
 
+    /* ---------------------------------------------------------------------- */
+
+    // The LLVM values generated for the module are stored in the tables below
+    // rather than on the symbols, methods, and types they belong to.  Those
+    // are shared between all modules whereas LLVM values belong to a single
+    // context: keeping them local to the code generator is what allows each
+    // module to be generated in its own context concurrently.
+
+    // symbol_values maps the module's symbols (including locals and
+    // parameters) to their LLVM values.
+    std::unordered_map<Symbol*, llvm::Value*> symbol_values;
+
+    // method_values maps the module's methods to their LLVM functions.
+    std::unordered_map<Method*, llvm::Value*> method_values;
+
+    // factory_values maps the module's factories to their LLVM functions.
+    std::unordered_map<FactoryFunc*, llvm::Value*> factory_values;
+
+    // struct_types maps struct types to their generated LLVM types.
+    std::unordered_map<Type*, llvm::Type*> struct_types;
+
+    // const_globals maps comptime values to the globals they are stored in.
+    std::unordered_map<ConstValue*, llvm::Constant*> const_globals;
+
+    // const_id_counter is used to generate unique names for constant globals.
+    size_t const_id_counter { 0 };
+
 public:
     // Creates a new code generator using ctx and outputting to mod.
     CodeGenerator(
         llvm::LLVMContext& ctx, 
         llvm::Module& mod, 
         Module& src_mod, 
-        bool debug,
-        MainBuilder& mainb,
-        Arena& arena
+        bool debug
     )
     : ctx(ctx), mod(mod), src_mod(src_mod), debug(debug, mod, irb)
-    , mainb(mainb), arena(arena)
     , irb(ctx)
     , layout(mod.getDataLayout())
     , loaded_imports(src_mod.deps.size())
@@ -207,6 +232,16 @@ public:
     // GenerateModule compiles the module.
     void GenerateModule();
 
+    // MangleName returns the mangled LLVM name of name declared in bry_mod.
+    static std::string MangleName(Module& bry_mod, std::string_view name);
+
+    // GetFuncLLName returns the LLVM name of the function declared by decl in
+    // bry_mod taking into account any attributes that override its name.
+    static std::string GetFuncLLName(Module& bry_mod, Decl* decl);
+
+    // GetInitFuncName returns the name of bry_mod's init function.
+    static std::string GetInitFuncName(Module& bry_mod);
+
 private:
     void createBuiltinGlobals();
     void genBuiltinFuncs();
@@ -246,8 +281,7 @@ private:
     enum {
         CTG_NONE = 0,
         CTG_CONST = 1,
-        CTG_EXPORTED = 2,
-        CTG_UNWRAPPED = 4
+        CTG_UNWRAPPED = 2
     };
     typedef int ComptimeGenFlags;
 
@@ -257,6 +291,7 @@ private:
     llvm::Constant* genComptimeString(ConstValue* value, ComptimeGenFlags flags);
     llvm::Constant* genComptimeStruct(ConstValue* value, ComptimeGenFlags flags, Type* expect_type);
     llvm::Constant* genComptimeInnerStruct(ConstValue *value, ComptimeGenFlags flags, Type* expect_type);
+    llvm::Constant* genConstGlobal(ConstValue* value, llvm::Constant* init, ComptimeGenFlags flags);
 
     /* ---------------------------------------------------------------------- */
 
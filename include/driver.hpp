@@ -12,6 +12,7 @@ enum OutputFormat {
     OUTFMT_OBJ,
     OUTFMT_ASM,
     OUTFMT_LLVM,
+    OUTFMT_CHECK,
 
     OUTFMT_DEFAULT,
     
@@ -26,6 +27,17 @@ enum DebugInfoFormat {
     DBGIS_COUNT
 };
 
+enum OptLevel {
+    OPTLVL_O0,
+    OPTLVL_O1,
+    OPTLVL_O2,
+    OPTLVL_O3,
+    OPTLVL_OS,
+    OPTLVL_OZ,
+
+    OPTLVLS_COUNT
+};
+
 struct BuildConfig {
     std::string input_path;
     std::vector<std::string> import_paths;
@@ -39,14 +51,49 @@ struct BuildConfig {
     std::vector<std::string> libs;
     std::vector<std::string> lib_paths;
 
-    int opt_level;
+    OptLevel opt_level;
+
+    // Zero means use one job per hardware thread.
+    int n_jobs;
+
+    // Whether to check the function bodies of a module in parallel.
+    bool parallel_check_bodies;
+
+    // The directory to cache generated objects in.  If this is empty, objects
+    // are not cached.
+    std::string cache_dir;
+
+    // Whether to build the snapshot of the standard library instead of
+    // compiling a program.
+    bool snapshot_std;
+
+    // Whether to print out the compilation steps and their durations.
+    bool verbose;
+
+    // The path to write the time trace of the build to.  If this is empty, the
+    // build is not traced.
+    std::string time_trace_path;
+
+    // Whether to print the statistics report after the build.
+    bool show_stats;
+
+    // Whether to print the memory used by the compiler's arenas at the end of
+    // each phase.
+    bool mem_report;
 
     BuildConfig()
     : out_path("berry-out")
     , out_fmt(OUTFMT_DEFAULT)
     , should_emit_debug(false)
     , debug_fmt(DBGI_NATIVE)
-    , opt_level(1)
+    , opt_level(OPTLVL_O1)
+    , n_jobs(0)
+    , parallel_check_bodies(false)
+    , cache_dir(".berry-cache")
+    , snapshot_std(false)
+    , verbose(false)
+    , show_stats(false)
+    , mem_report(false)
     {}
 };
 
@@ -0,0 +1,21 @@
+#ifndef FINGERPRINT_H_INC
+#define FINGERPRINT_H_INC
+
+#include "hir.hpp"
+
+// FingerprintDecl returns the fingerprint of an exported declaration of mod: a
+// hash of everything about the declaration that code generated for another
+// module importing it can depend on.  This includes the declaration's name,
+// signature or type (with the layouts of any named types fully expanded),
+// attributes, and constant value, but not the bodies of functions since they
+// are only ever called through external declarations.  Thus, the fingerprint
+// only changes when importers of the declaration need to be rebuilt.
+std::string FingerprintDecl(Module& mod, Decl* decl);
+
+// FingerprintInterface returns the fingerprint of the whole interface of mod:
+// all its exported declarations along with all its methods and factories
+// (which can be bound to the types of other modules).  Modules importing mod
+// only need to be checked again when this fingerprint changes.
+std::string FingerprintInterface(Module& mod);
+
+#endif
@@ -118,24 +118,16 @@ struct ConstValue {
         struct {
             std::span<ConstValue*> elems;
             Type* elem_type;
-            size_t mod_id;
-            llvm::Constant* alloc_loc;
         } v_array;
         struct {
             uint64_t num_elems;
             Type* elem_type;
-            size_t mod_id;
-            llvm::Constant* alloc_loc;
         } v_zarr;
         struct {
             std::string_view value;
-            size_t mod_id;
-            llvm::Constant* alloc_loc;
         } v_str;
         struct {
             std::span<ConstValue*> fields;
-            size_t mod_id;
-            llvm::Constant* alloc_loc;
         } v_struct;
         uint64_t v_enum;
     };
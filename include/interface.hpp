@@ -0,0 +1,91 @@
+#ifndef INTERFACE_H_INC
+#define INTERFACE_H_INC
+
+#include "hir.hpp"
+#include "mapped_file.hpp"
+#include "sha256.hpp"
+
+#define BERRY_INTERFACE_EXT ".bmi"
+
+// InterfaceHeader is the part of a module interface file which is used to
+// determine whether the interface is still up to date.
+struct InterfaceHeader {
+    // config_key identifies the compiler and target configuration the module
+    // was checked with.
+    std::string config_key;
+
+    // source_hash is the hash of the module's source files.
+    std::string source_hash;
+
+    // mod_id is the ID the module was assigned.  Module IDs appear in mangled
+    // names so the interface can only be used if the module gets the same ID.
+    size_t mod_id;
+
+    // fingerprint is the fingerprint of the module's exported interface.
+    std::string fingerprint;
+
+    // obj_key is the build cache key of the module's object.
+    std::string obj_key;
+
+    // Dep is one of the module's dependencies along with the fingerprint of its
+    // interface when the module was checked.
+    struct Dep {
+        std::vector<std::string> mod_path;
+        size_t mod_id;
+        std::string fingerprint;
+    };
+
+    // deps stores the module's dependencies in the same order as Module::deps.
+    std::vector<Dep> deps;
+};
+
+// WriteInterface writes the interface of mod to the file at path.  mod must
+// already be checked.  The interface contains the module's type definitions,
+// method and factory declarations, and all its other exported declarations:
+// everything needed to check and generate code for modules importing it.  This
+// returns false if the file could not be written.
+bool WriteInterface(const std::string& path, Module& mod, const InterfaceHeader& header);
+
+// InterfaceFile is a module interface file which has been mapped into memory.
+// The names and string constants of the declarations loaded from the file point
+// directly into the mapping rather than being copied, so the file must outlive
+// the module it is loaded into.
+class InterfaceFile {
+    // file is the mapping of the file.
+    MappedFile file;
+
+    // body_start is the offset of the body of the file (after the header).
+    size_t body_start { 0 };
+
+public:
+    // header is the header of the interface file.
+    InterfaceHeader header;
+
+    // Open maps the interface file at path and decodes its header.  This
+    // returns false if the file can't be read or is malformed.
+    bool Open(const std::string& path);
+
+    // Load populates mod with the declarations stored in the interface file.
+    // The symbols and types are allocated in arena.  mods_by_id maps module IDs
+    // to modules: every module whose types are referenced by the interface
+    // must already be loaded.  If the interface is malformed or references a
+    // missing declaration, this returns false and leaves mod unchanged.
+    bool Load(Module& mod, Arena& arena, const std::vector<Module*>& mods_by_id);
+};
+
+// OpenInterfaceFile returns the interface file at path, or nullptr if it can't
+// be opened.  Interface files stay mapped for the lifetime of the process and
+// are only opened again if they change on disk: this lets a compile server
+// reuse them between builds.  This is safe to call concurrently.
+std::shared_ptr<InterfaceFile> OpenInterfaceFile(const std::string& path);
+
+// GetInterfaceKey returns the build cache key of the interface file of mod.  The
+// key is derived from the paths of the module's source files.
+std::string GetInterfaceKey(Module& mod);
+
+// HashSourceFile adds the paths and contents of src_file to hasher, the hash of
+// its module's sources.  src must be the text of the file which is used: that
+// is the text which is actually lexed.
+void HashSourceFile(Sha256& hasher, const SourceFile& src_file, std::string_view src);
+
+#endif
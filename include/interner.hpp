@@ -0,0 +1,52 @@
+#ifndef INTERNER_H_INC
+#define INTERNER_H_INC
+
+#include <unordered_map>
+
+#include "arena.hpp"
+
+// InternName returns the canonical copy of name: every call with an equal
+// name returns a view of the same memory.  Interned names live for the rest
+// of the process and store their hash so that it never has to be recomputed.
+// This can be called from any thread.
+std::string_view InternName(std::string_view name);
+
+// IsInterned returns whether name is exactly a canonical name returned by
+// InternName.  Views of part of an interned name are not interned.
+bool IsInterned(std::string_view name);
+
+// HashName returns the hash of name.  The hash of an interned name is read
+// from where it was stored when the name was interned: all other names are
+// hashed from their contents.
+uint64_t HashName(std::string_view name);
+
+// GetNameArena returns the arena the interned names are stored in.
+const Arena& GetNameArena();
+
+// NameHash hashes names for use in hash tables.
+struct NameHash {
+    inline size_t operator()(std::string_view name) const {
+        return (size_t)HashName(name);
+    }
+};
+
+// NameEq compares names for use in hash tables.  Interned names are equal only
+// if they are the same name so comparing them is just a pointer comparison.
+// Names which are not interned (eg. names written in the compiler itself)
+// are still compared by content.
+struct NameEq {
+    inline bool operator()(std::string_view a, std::string_view b) const {
+        if (a.data() == b.data()) {
+            return a.size() == b.size();
+        }
+
+        return a == b;
+    }
+};
+
+// NameMap is a hash table keyed by names.  It works with any names but is
+// fastest when its keys and the names looked up in it are interned.
+template<typename T>
+using NameMap = std::unordered_map<std::string_view, T, NameHash, NameEq>;
+
+#endif
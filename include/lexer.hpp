@@ -1,9 +1,6 @@
 #ifndef LEXER_H_INC
 #define LEXER_H_INC
 
-#include <iostream>
-#include <fstream>
-
 #include "token.hpp"
 #include "symbol.hpp"
 
@@ -11,16 +8,23 @@
 // This type is used to make the number lexing code more reusable.
 typedef bool (*DigitCheckFunc)(rune r);
 
-// Lexer tokenizes a file into lexemes.
+// Lexer tokenizes a file into lexemes.  The lexer works over a buffer holding
+// the whole file, and the tokens it produces refer directly into that buffer:
+// no token text is ever copied.  Runs of ASCII text (whitespace, comments,
+// identifiers, digits and string contents) are scanned in bulk; only other
+// runes are decoded and validated one by one.
 class Lexer {
-    // file is the file stream being read.
-    std::ifstream& file;
+    // src is the contents of the file being lexed.
+    std::string_view src;
 
     // src_file is the Berry source file being lexed.
     const SourceFile& src_file;
 
-    // tok_buff is the buffer used to build the current token.
-    std::string tok_buff;
+    // pos is the offset in src of the lookahead rune.
+    size_t pos;
+
+    // tok_start is the offset in src of the start of the current token.
+    size_t tok_start;
 
     // line and col indicate the lexer's current position in the file.
     size_t line, col;
@@ -31,15 +35,14 @@ class Lexer {
     // ahead is the lookahead rune (peeked but not read).
     rune ahead;
 
-    // rbuff stores the UTF-8 bytes of the lookahead.
-    char rbuff[4];
-
-    // rlen is the number of bytes rbuff needed to represent the lookahead.
-    int rlen;
+    // alen is the number of bytes of the lookahead in src.  It is zero if no
+    // rune has been peeked.
+    int alen;
 
 public:
-    // Creates a new lexer reading from file for src_file.
-    Lexer(std::ifstream& file, const SourceFile& src_file);
+    // Creates a new lexer reading from src, the contents of src_file.  src must
+    // outlive every token produced by the lexer.
+    Lexer(std::string_view src, const SourceFile& src_file);
 
     // NextToken reads the next token from the lexer into tok.
     void NextToken(Token &tok);
@@ -120,22 +123,31 @@ private:
     // mark marks the lexer's current position as the start of the next token.
     void mark();
 
-    // makeToken creates a new token stored in tok from the contents of tok_buff
-    // of kind kind.  This clears tok_buff.
-    void makeToken(Token &tok, TokenKind kind);
+    // makeToken creates a new token stored in tok of kind kind whose value is
+    // the source text from the start of the token to the lexer's position
+    // with trim_start bytes cut off the front and trim_end bytes cut off the
+    // back (eg. to remove the quotes of a string literal).
+    void makeToken(Token &tok, TokenKind kind, size_t trim_start = 0, size_t trim_end = 0);
 
     /* ---------------------------------------------------------------------- */
 
     // updatePos updates the lexer's line and column based on r.
     void updatePos(rune r);
 
-    // read moves the lexer forward one rune and writes it into tok_buff. The
-    // read-in rune is returned.
+    // read moves the lexer forward one rune.  The read-in rune is returned.
     rune read();
 
-    // skip moves the lexer forward one rune without writing said rune into
-    // tok_buff.  The skipped rune is returned.
-    rune skip();
+    // readAscii moves the lexer forward to stop which must be the end of a run
+    // of ASCII text starting at the lexer's position (found using one of the
+    // scans in scan.hpp).  This is the lexer's fast path: it moves over the
+    // whole run at once instead of rune by rune.
+    void readAscii(const char* stop);
+
+    // curr returns a pointer to the lexer's position in src.
+    inline const char* curr() const { return src.data() + pos; }
+
+    // srcEnd returns a pointer to the end of src.
+    inline const char* srcEnd() const { return src.data() + src.size(); }
 
     // peek reads the next rune into ahead without moving the lexer forward. It
     // returns false if an EOF is encountered.
@@ -143,8 +155,8 @@ private:
 
     /* ---------------------------------------------------------------------- */
 
-    // getRune reads a UTF8 encoded rune from file.  The bytes of the rune are
-    // stored in rbuff, and the number of bytes of the rune is stored in rlen.
+    // getRune decodes the UTF8 encoded rune at pos without moving the lexer
+    // forward.  The number of bytes of the rune is stored in alen.
     rune getRune();
 
     /* ---------------------------------------------------------------------- */
@@ -161,4 +173,8 @@ private:
     TextSpan getSpan();
 };
 
+// KeywordKind returns the token kind of the keyword word or TOK_IDENT if word
+// is not a keyword.
+TokenKind KeywordKind(std::string_view word);
+
 #endif
\ No newline at end of file
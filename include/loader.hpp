@@ -7,6 +7,8 @@
 namespace fs = std::filesystem;
 
 #include "symbol.hpp"    
+#include "build_cache.hpp"
+#include "interface.hpp"
 
 #define BERRY_FILE_EXT ".bry"
 
@@ -14,7 +16,12 @@ class Loader {
     using ModuleTable = std::unordered_map<std::string, Module>;
 
     Arena& global_arena;
-    Arena& ast_arena;
+
+    // n_workers is the number of workers used to parse modules concurrently.
+    // The parse workers all allocate in global_arena, so it must be a
+    // concurrent arena.  Each module's AST goes in its own arena.
+    size_t n_workers;
+
     ModuleTable mod_table;
     std::vector<fs::path> import_paths;
 
@@ -29,14 +36,80 @@ class Loader {
     };
     std::queue<LoadEntry> load_queue;
 
+    struct ParseEntry {
+        fs::path local_path;
+        Module* mod;
+    };
+
+    // parse_wave is the list of modules which have been discovered but not yet
+    // parsed.  Modules are parsed a wave at a time: all the modules in a wave
+    // are parsed in parallel, and their imports are then resolved in order to
+    // produce the next wave.  This keeps both module IDs and error messages in
+    // the same order as if the modules had been loaded one by one.
+    std::vector<ParseEntry> parse_wave;
+
     std::vector<Module*> sorted_mods;
 
+    // interfaces_enabled indicates whether modules can be loaded from their
+    // interface files.
+    bool interfaces_enabled { false };
+
+    // interface_caches are the build caches to load module interface files
+    // from in order of preference.  The standard library snapshot (if there is
+    // one) always comes first.
+    std::vector<const BuildCache*> interface_caches;
+
+    // std_snapshot is the snapshot of the standard library.
+    std::unique_ptr<BuildCache> std_snapshot;
+
+    // interface_config_key is the configuration key interface files must have
+    // been written with to be used.
+    std::string interface_config_key;
+
+    // interface_obj_ext is the file extension of cached objects.
+    std::string interface_obj_ext;
+
+    // InterfaceEntry is the interface file of a module which may be loaded from
+    // it instead of being parsed.
+    struct InterfaceEntry {
+        fs::path local_path;
+        const BuildCache* cache;
+        std::shared_ptr<InterfaceFile> file;
+    };
+
+    // interfaces stores the interface entries of all the modules whose sources
+    // are unchanged since their interface files were written.
+    std::unordered_map<Module*, InterfaceEntry> interfaces;
+
+    // loaded_interfaces stores the interface files modules were loaded from:
+    // the modules point into them.
+    std::vector<std::shared_ptr<InterfaceFile>> loaded_interfaces;
+
 public:
-    Loader(Arena& global_arena, Arena& ast_arena, const std::vector<std::string>& import_paths);
+    Loader(Arena& global_arena, const std::vector<std::string>& import_paths, size_t n_workers);
     void LoadAll(const std::string& root_mod);
 
+    // LoadStd loads only the default modules of the standard library (core and
+    // runtime) from source.  There is no root module.
+    void LoadStd();
+
+    // EnableInterfaces makes the loader load modules from their interface
+    // files instead of parsing them whenever possible: when their sources and
+    // the interfaces of their dependencies are unchanged, and their objects are
+    // still cached.  Interface files are looked up in the standard library
+    // snapshot and then in cache (which may be nullptr).  config_key identifies
+    // the compiler and target configuration, and obj_ext is the file extension
+    // of objects.  The root module is always loaded from source.
+    void EnableInterfaces(const BuildCache* cache, const std::string& config_key, const std::string& obj_ext);
+
+    // GetStdSnapshotDir returns the directory the standard library snapshot is
+    // stored in.
+    static std::string GetStdSnapshotDir();
+
     std::vector<Module*>& SortModulesByDepGraph();
-    inline Module& GetRootModule() { return *root_mod; }
+    // GetRootModule returns the root module.  This is nullptr if only the
+    // standard library was loaded.
+    inline Module* GetRootModule() { return root_mod; }
 
     /* ---------------------------------------------------------------------- */
 
@@ -69,12 +142,18 @@ public:
 
 private:
     Module& loadDefaults();
+    void finishLoading(Module& core_mod);
     void loadRootModule(fs::path& root_mod_abs_path);
     Module& loadModule(const fs::path& local_path, const fs::path& mod_abs_path);
 
     /* ---------------------------------------------------------------------- */
 
     Module& initModule(const fs::path& local_path, const fs::path& mod_abs_path);
+    void loadWaves();
+    void parseWave();
+    const BuildCache* openInterface(Module& mod, std::shared_ptr<InterfaceFile>& itf);
+    void loadInterfaces(Module& core_mod);
+    bool isInterfaceValid(Module& mod, const BuildCache& cache, const InterfaceHeader& header);
     void parseModule(Module& mod);
     void resolveImports(const fs::path& local_path, Module& mod);
     std::optional<fs::path> findModule(const fs::path& search_path, const std::vector<std::string>& mod_path);
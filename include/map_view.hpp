@@ -3,50 +3,54 @@
 
 #include <optional>
 
-#include "arena.hpp"
-
+#include "interner.hpp"
+
+// MapView is an immutable name-keyed hash table stored in an arena.  It is
+// built once from a NameMap and then only read.  The table is a flat
+// open addressing table with linear probing: each slot stores the hash of its
+// key so that probing only compares keys whose hashes match, and the table is
+// kept at most half full so that probe sequences stay short.  Keys should be
+// interned names so that their hashes don't need to be computed.
 template<typename T>
 class MapView {
-    struct MapBucket {
+    struct MapSlot {
+        // hash is the hash of the slot's key.  It is zero if the slot is empty.
+        uint64_t hash;
         std::string_view key;
         T value;
-        MapBucket* next;
     };
 
-    std::span<MapBucket*> table;
+    std::span<MapSlot> table;
     size_t n_pairs;
 
-    static inline std::hash<std::string_view> hasher {};
-
 public:
-    MapView(Arena& arena, std::unordered_map<std::string_view, T>&& map) 
+    MapView(Arena& arena, NameMap<T>&& map)
     : n_pairs(map.size())
     {
-        auto n_buckets = map.bucket_count();
-        auto* table_ptr = (MapBucket**)arena.Alloc(n_buckets * sizeof(MapBucket*));
-        memset(table_ptr, 0, sizeof(MapBucket*) * n_buckets);
-
-        table = std::span<MapBucket*>(table_ptr, n_buckets);
+        // The number of slots is a power of two so that the hash can be masked
+        // instead of divided.
+        size_t n_slots = 1;
+        while (n_slots < map.size() * 2) {
+            n_slots <<= 1;
+        }
 
-        for (auto& pair : map) {
-            auto hndx = hasher(pair.first) % table.size();
+        auto* table_ptr = (MapSlot*)arena.Alloc(n_slots * sizeof(MapSlot));
+        memset((void*)table_ptr, 0, sizeof(MapSlot) * n_slots);
 
-            auto* new_bucket = (MapBucket*)arena.Alloc(sizeof(MapBucket));
-            new_bucket->key = pair.first;
-            new_bucket->value = std::move(pair.second);
-            new_bucket->next = nullptr;
+        table = std::span<MapSlot>(table_ptr, n_slots);
 
-            auto* bucket = table[hndx];
-            if (bucket == nullptr) {
-                table[hndx] = new_bucket;
-                continue;
-            }
+        for (auto& pair : map) {
+            auto hash = hashKey(pair.first);
 
-            while (bucket->next != nullptr) {
-                bucket = bucket->next;
+            size_t ndx = hash & (table.size() - 1);
+            while (table[ndx].hash != 0) {
+                ndx = (ndx + 1) & (table.size() - 1);
             }
 
-            bucket->next = new_bucket;
+            auto& slot = table[ndx];
+            slot.hash = hash;
+            slot.key = pair.first;
+            std::construct_at(&slot.value, std::move(pair.second));
         }
 
         map.clear();
@@ -57,27 +61,37 @@ public:
     inline T& operator[](std::string_view key) { return get(key); }
 
     T& get(std::string_view key) {
-        auto* bucket = lookup(key);
+        auto* slot = lookup(key);
 
-        if (bucket == nullptr)
+        if (slot == nullptr)
             Panic("map view has no key named {}", key);
 
-        return bucket->value;
+        return slot->value;
     }
 
     std::optional<T> try_get(std::string_view key) {
-        auto* bucket = lookup(key);
+        auto* slot = lookup(key);
 
-        if (bucket == nullptr)
+        if (slot == nullptr)
             return {};
 
-        return bucket->value;
+        return slot->value;
+    }
+
+    // for_each calls fn(key, value) for every pair in the map.  The pairs are
+    // visited in an unspecified order.
+    template<typename F>
+    void for_each(F fn) {
+        for (auto& slot : table) {
+            if (slot.hash != 0) {
+                fn(slot.key, slot.value);
+            }
+        }
     }
 
     class MapIterator {
-        MapView& view;
-        size_t ndx;
-        MapBucket* bucket;
+        MapSlot* slot;
+        MapSlot* end;
 
         friend class MapView;
 
@@ -88,26 +102,20 @@ public:
         using pointer = value_type*;
         using reference = value_type&;
 
-        MapIterator(MapView& view, size_t start_ndx)
-        : view(view)
-        , ndx(start_ndx)
-        , bucket(nullptr)
+        MapIterator(MapSlot* start, MapSlot* end)
+        : slot(start)
+        , end(end)
         {
-            while (ndx < view.table.size() && bucket == nullptr) {
-                bucket = view.table[++ndx];
-            }
+            skipEmpty();
         }
 
-        reference operator*() { return bucket->value; }
-        pointer operator->() { return &bucket->value; }
+        reference operator*() { return slot->value; }
+        pointer operator->() { return &slot->value; }
 
         MapIterator& operator++() {
-            if (bucket == nullptr)
-                return *this;
-
-            bucket = bucket->next;
-            while (ndx < view.table.size() && bucket == nullptr) {
-                bucket = view.table[++ndx];
+            if (slot != end) {
+                slot++;
+                skipEmpty();
             }
 
             return *this;
@@ -115,27 +123,43 @@ public:
 
         MapIterator operator++(int) { auto tmp = *this; ++(*this); return tmp; }
 
-        friend bool operator==(const MapIterator& a, const MapIterator& b) { return a.bucket == b.bucket; }
-        friend bool operator!=(const MapIterator& a, const MapIterator& b) { return a.bucket != b.bucket; }
+        friend bool operator==(const MapIterator& a, const MapIterator& b) { return a.slot == b.slot; }
+        friend bool operator!=(const MapIterator& a, const MapIterator& b) { return a.slot != b.slot; }
+
+    private:
+        void skipEmpty() {
+            while (slot != end && slot->hash == 0) {
+                slot++;
+            }
+        }
     };
 
-    MapIterator begin() { return MapIterator(*this, 0); }
-    MapIterator end() { return MapIterator(*this, table.size()); }
+    MapIterator begin() { return MapIterator(table.data(), table.data() + table.size()); }
+    MapIterator end() { return MapIterator(table.data() + table.size(), table.data() + table.size()); }
 
 private:
-    MapBucket* lookup(std::string_view key) {
-        auto hndx = hasher(key) % table.size();
+    // hashKey computes the hash of key.  Zero is reserved for empty slots.
+    static uint64_t hashKey(std::string_view key) {
+        auto hash = HashName(key);
+        return hash == 0 ? 1 : hash;
+    }
+
+    MapSlot* lookup(std::string_view key) {
+        // Empty maps still have one (empty) slot so there is no need to check
+        // for an empty table.
+        auto hash = hashKey(key);
 
-        auto* bucket = table[hndx];
-        while (bucket != nullptr) {
-            if (bucket->key == key)
-                return bucket;
+        size_t ndx = hash & (table.size() - 1);
+        while (table[ndx].hash != 0) {
+            auto& slot = table[ndx];
+            if (slot.hash == hash && NameEq{}(slot.key, key))
+                return &slot;
 
-            bucket = bucket->next;
+            ndx = (ndx + 1) & (table.size() - 1);
         }
 
-        return bucket;
+        return nullptr;
     }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,38 @@
+#ifndef MAPPED_FILE_H_INC
+#define MAPPED_FILE_H_INC
+
+#include "base.hpp"
+
+// MappedFile is a read-only memory mapping of a whole file.  The contents of
+// the file are paged in lazily by the OS, and the mapping is shared with every
+// other process mapping the same file.
+class MappedFile {
+    // data points to the start of the mapping.
+    const char* data { nullptr };
+
+    // size is the size of the file in bytes.
+    size_t size { 0 };
+
+#if OS_WINDOWS
+    // mapping_handle is the handle to the file mapping object.
+    void* mapping_handle { nullptr };
+#endif
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    // Open maps the file at path into memory.  This returns false if the file
+    // can't be opened or mapped (eg. because it is empty).
+    bool Open(const std::string& path);
+
+    // Close unmaps the file.  All views into the file are invalidated.
+    void Close();
+
+    // View returns the contents of the file.
+    inline std::string_view View() const { return { data, size }; }
+};
+
+#endif
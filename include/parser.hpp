@@ -4,8 +4,9 @@
 #include "ast.hpp"
 #include "lexer.hpp"
 #include "arena.hpp"
+#include "interner.hpp"
 
-using AttributeMap = std::unordered_map<std::string_view, Attribute>;
+using AttributeMap = NameMap<Attribute>;
 
 // Parser parses a Berry file into an AST and catches syntax errors.
 class Parser {    
@@ -44,12 +45,14 @@ class Parser {
     int meta_if_depth { 0 };
 
 public:
-    // Creates a new parser reading from file for src_file.
-    Parser(Arena& global_arena, Arena& ast_arena, std::ifstream& file, SourceFile& src_file)
+    // Creates a new parser reading from src, the contents of src_file.  src
+    // only needs to outlive the parser: everything the AST keeps from it is
+    // copied out of it.
+    Parser(Arena& global_arena, Arena& ast_arena, std::string_view src, SourceFile& src_file)
     : global_arena(global_arena)
     , ast_arena(ast_arena)
     , src_file(src_file)
-    , lexer(file, src_file)
+    , lexer(src, src_file)
     {}
     
     // ParseFile runs the parser on the parser's file.
@@ -71,7 +74,7 @@ private:
     AstNode* parseFuncOrMethodDecl(bool exported);
     AstNode* parseFactoryDecl(bool exported);
     AstNode* parseFuncSignature();
-    void parseFuncParams(std::vector<AstFuncParam>& params);
+    void parseFuncParams(ArenaList<AstFuncParam>& params);
 
     AstNode* parseGlobalVarDecl(bool exported);
     
@@ -138,7 +141,7 @@ private:
     std::string evaluateMetaUnaryExpr();
     std::string evaluateMetaValue();
 
-    std::string_view lookupMetaVar(const std::string& name);
+    std::string_view lookupMetaVar(std::string_view name);
 
     /* ---------------------------------------------------------------------- */
 
@@ -194,7 +197,8 @@ private:
     }
 };
 
-bool ConvertUint(const std::string& int_str, uint64_t* value);
-rune ConvertRuneLit(const std::string& rune_str); 
+bool ConvertUint(std::string_view int_str, uint64_t* value);
+bool ConvertFloat(std::string_view float_str, double* value);
+rune ConvertRuneLit(std::string_view rune_str); 
 
 #endif
\ No newline at end of file
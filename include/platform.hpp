@@ -29,7 +29,7 @@
     #define OS_WINDOWS 1
 #elif defined(__APPLE__) && defined(__MACH__)
     #define OS_DARWIN 1
-#elif defined(__UNIX__)
+#elif defined(__unix__)
     #define OS_UNIX 1
 
     #ifdef __linux__
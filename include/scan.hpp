@@ -0,0 +1,40 @@
+#ifndef SCAN_H_INC
+#define SCAN_H_INC
+
+#include "base.hpp"
+
+// The scan functions below are the lexer's ASCII fast paths.  Each one returns
+// a pointer to the first byte in [p, end) which ends the run of bytes it scans
+// for (or end if there is no such byte).  Bytes which are not ASCII always end
+// a run so that multi-byte runes are left for the lexer to decode and validate.
+// The scans use SSE2 to test 16 bytes at a time where it is available and fall
+// back to scanning byte by byte elsewhere.
+
+// ScanWhitespace scans a run of spaces, tabs, carriage returns and newlines.
+const char* ScanWhitespace(const char* p, const char* end);
+
+// ScanIdent scans a run of identifier characters: letters, digits and `_`.
+const char* ScanIdent(const char* p, const char* end);
+
+// ScanDecDigits scans a run of decimal digits.
+const char* ScanDecDigits(const char* p, const char* end);
+
+// ScanStrChars scans a run of string literal characters which need no special
+// handling: that is anything other than `"`, `\` and newlines.
+const char* ScanStrChars(const char* p, const char* end);
+
+// ScanLineComment scans a run of line comment characters: anything other than
+// a newline.
+const char* ScanLineComment(const char* p, const char* end);
+
+// ScanBlockComment scans a run of block comment characters which can't end the
+// comment: anything other than `*`.
+const char* ScanBlockComment(const char* p, const char* end);
+
+// AdvanceTextPos moves the text position given by line and col over the ASCII
+// text in [p, end) in the same way the lexer does rune by rune: a newline
+// starts a new line at column 1, a tab counts for 4 columns, and every other
+// byte counts for 1.
+void AdvanceTextPos(const char* p, const char* end, size_t& line, size_t& col);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef SERVER_H_INC
+#define SERVER_H_INC
+
+#include "driver.hpp"
+
+// The environment variable naming the socket of the compile server.  When it
+// is set, the compiler forwards its builds to the server.
+#define BERRY_SERVER_ENV_VAR "BERRY_SERVER"
+
+// GetServerSocketPath returns the path to the socket of the compile server: the
+// value of BERRY_SERVER if it is set or a default path in the temp directory.
+std::string GetServerSocketPath();
+
+// RunServer runs the compiler as a compile server listening on the Unix socket
+// at socket_path.  The server handles builds one at a time for as long as it
+// is running, reusing the state which doesn't change between builds: the LLVM
+// targets and the mapped module interface files.  This only returns if the
+// socket can't be created.
+void RunServer(const std::string& socket_path);
+
+// ForwardToServer runs the build described by cfg on the compile server
+// listening at socket_path and displays the diagnostics it reports.  The build
+// runs in the current working directory, and its artifacts are written by the
+// server.  This returns false if the server can't be reached or if the build
+// asks for output that is printed rather than reported as diagnostics (verbose
+// output, statistics or a memory report): the build should then be run
+// locally.  Otherwise, build_ok is set to whether the build
+// succeeded.
+bool ForwardToServer(const std::string& socket_path, const BuildConfig& cfg, bool& build_ok);
+
+#endif
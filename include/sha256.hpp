@@ -0,0 +1,42 @@
+#ifndef SHA256_H_INC
+#define SHA256_H_INC
+
+#include "base.hpp"
+
+// Sha256 incrementally computes the SHA-256 digest of a stream of bytes.  It is
+// used to derive the content-addressed keys of build artifacts.
+class Sha256 {
+    // state is the current hash state (H0 through H7).
+    uint32_t state[8];
+
+    // block stores the bytes of the current partial block.
+    uint8_t block[64];
+
+    // block_len is the number of bytes in the current partial block.
+    size_t block_len { 0 };
+
+    // total_len is the total number of bytes hashed so far.
+    uint64_t total_len { 0 };
+
+public:
+    Sha256();
+
+    // Update adds len bytes starting at data to the hash.
+    void Update(const void* data, size_t len);
+
+    // Update adds the bytes of str to the hash.  The length of str is hashed
+    // before its contents so that adjacent strings can't run together.
+    void Update(std::string_view str);
+
+    // Update adds the bytes of value to the hash.
+    void Update(uint64_t value);
+
+    // HexDigest completes the hash and returns its digest as a hex string.
+    // The hash can't be updated after this is called.
+    std::string HexDigest();
+
+private:
+    void processBlock(const uint8_t* data);
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef STATS_H_INC
+#define STATS_H_INC
+
+#include "ast.hpp"
+#include "hir.hpp"
+
+// StatCounter is a counter collected for the statistics report.
+enum StatCounter {
+    STAT_TOKENS,
+    STAT_COMPTIME_EVALS,
+
+    // The runtime checks emitted by the code generator, and those which are
+    // kept after optimization: the rest are elided by the optimizer.
+    STAT_BOUNDS_CHECKS,
+    STAT_BOUNDS_CHECKS_KEPT,
+    STAT_OVERFLOW_CHECKS,
+    STAT_OVERFLOW_CHECKS_KEPT,
+    STAT_DIVIDE_CHECKS,
+    STAT_DIVIDE_CHECKS_KEPT,
+
+    STATS_COUNT
+};
+
+// stats_enabled indicates whether statistics are being collected.  It is only
+// changed while no compilation is running.
+extern bool stats_enabled;
+
+// StartStats resets all the statistics and starts collecting them.
+void StartStats();
+
+// PrintStats stops collecting statistics and prints the statistics report.
+void PrintStats();
+
+// RecordModuleCodeStats records the size of the LLVM module generated for the
+// Berry module named mod_name: n_funcs is the number of functions defined in
+// it, and n_instrs and n_opt_instrs are the number of instructions in it
+// before and after optimization respectively.
+void RecordModuleCodeStats(std::string_view mod_name, uint64_t n_funcs, uint64_t n_instrs, uint64_t n_opt_instrs);
+
+/* -------------------------------------------------------------------------- */
+
+// Counters are collected per thread so counting never requires any locking.
+// The functions below only do anything if statistics are enabled.
+
+void impl_CountStat(StatCounter counter, uint64_t n);
+void impl_CountAstNode(AstKind kind);
+void impl_CountHirNode(HirKind kind);
+void impl_CountType(TypeKind kind);
+
+// CountStat adds n to counter.
+inline void CountStat(StatCounter counter, uint64_t n = 1) {
+    if (stats_enabled) {
+        impl_CountStat(counter, n);
+    }
+}
+
+// CountAstNode counts an allocated AST node of the given kind.
+inline void CountAstNode(AstKind kind) {
+    if (stats_enabled) {
+        impl_CountAstNode(kind);
+    }
+}
+
+// CountHirNode counts an allocated HIR node of the given kind.
+inline void CountHirNode(HirKind kind) {
+    if (stats_enabled) {
+        impl_CountHirNode(kind);
+    }
+}
+
+// CountType counts an allocated type of the given kind.
+inline void CountType(TypeKind kind) {
+    if (stats_enabled) {
+        impl_CountType(kind);
+    }
+}
+
+#endif
@@ -45,9 +45,6 @@ struct Symbol {
 
     // immut indicates whether the symbol is immutable.
     bool immut { false };
-
-    // llvm_value contains the LLVM value bound to the symbol.
-    llvm::Value* llvm_value { nullptr };
 };
 /* -------------------------------------------------------------------------- */
 
@@ -87,10 +84,13 @@ struct Decl {
     // attrs contains the declaration's attributes.
     std::span<Attribute> attrs;
 
-    // ast_decl is the declaration AST node.
+    // ast_decl is the declaration AST node.  It is cleared once the module is
+    // checked and its AST is released.
     AstNode* ast_decl;
 
-    // hir_decl is the declaration HIR node.
+    // hir_decl is the declaration HIR node.  The statements and expressions
+    // it refers to (eg. function bodies) are released once the module is
+    // generated: only the declaration itself can be used after that.
     HirDecl* hir_decl { nullptr };
 
     // color the declarations current graph color (used for cycle detection).
@@ -121,7 +121,7 @@ struct Module {
     std::vector<SourceFile> files;
 
     // symbol_table is the module's global symbol table.
-    std::unordered_map<std::string_view, Symbol*> symbol_table;
+    NameMap<Symbol*> symbol_table;
 
     // decls stores all the module's declarations.  This vector will be sorted
     // into correct initialization order after type checking is done.
@@ -174,6 +174,37 @@ struct Module {
     // module.  It is arranged as a linked list so as to guarantee the validity
     // of pointers to its elements as the list changes in size.
     std::unique_ptr<MtableNode> mtable_list { nullptr };
+
+    // from_interface indicates that the module was loaded from its interface
+    // file rather than from source.  Such modules are not checked or generated:
+    // only the declarations other modules can use are loaded.
+    bool from_interface { false };
+
+    // obj_key is the build cache key of the object of a module loaded from its
+    // interface file, and obj_path is the path to that object.
+    std::string obj_key;
+    std::string obj_path;
+
+    // fingerprint is the fingerprint of the module's interface.  It is only set
+    // for modules which are loaded from or written to interface files.
+    std::string fingerprint;
+
+    // source_hash is the hash of the paths and contents of the module's source
+    // files.  It is computed from the text the module was parsed from, or the
+    // text its interface file was checked against, so that the cache never
+    // stores anything under the hash of text it wasn't built from.
+    std::string source_hash;
+
+    // ast_arena holds the module's AST.  Only the module's own checker uses
+    // the AST, so it is released as soon as the module has been checked.
+    Arena ast_arena { ARENA_AST };
+
+    // hir_arena holds the HIR statements and expressions of the module: the
+    // bodies and initializers of its declarations.  Other modules only use
+    // the HIR declarations, so it is released as soon as the module has been
+    // generated.  Function bodies may be checked in parallel so it is a
+    // concurrent arena.
+    Arena hir_arena { ARENA_HIR, true };
 };
 
 // SourceFile represents a single source file in a Berry module.
@@ -191,7 +222,7 @@ struct SourceFile {
     std::string display_path;
     
     // import_table stores the file's named imports.
-    std::unordered_map<std::string_view, size_t> import_table;
+    NameMap<size_t> import_table;
 
     // anon_imports stores the file's anonymous imports (`import pkg as _`).
     std::unordered_set<size_t> anon_imports;
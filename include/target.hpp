@@ -3,10 +3,16 @@
 
 #include "types.hpp"
 
-#include "llvm/IR/LLVMContext.h"
 #include "llvm/TargetParser/Triple.h"
 #include "llvm/IR/DataLayout.h"
 
+// TypeLayout is the size and alignment of a type on the target.
+struct TypeLayout {
+    uint64_t size;
+    uint64_t abi_align;
+    uint64_t pref_align;
+};
+
 struct TargetPlatform {
     std::string os_name;
     std::string arch_name;
@@ -17,9 +23,19 @@ struct TargetPlatform {
     bool debug;
     std::string str_debug;
 
-    llvm::LLVMContext ll_context;
     llvm::Triple ll_triple;
-    llvm::DataLayout* ll_layout;
+
+    // ll_layout is the LLVM data layout of the target.  It is only created if
+    // code is generated.
+    llvm::DataLayout* ll_layout { nullptr };
+
+    // The layout model is a description of the target's data layout which is
+    // used to compute comptime sizes and alignments without LLVM.  It mirrors
+    // the rules LLVM uses for the target so that both always agree.
+    uint64_t ptr_size;              // Size and alignment of pointers
+    uint64_t i64_abi_align;         // ABI alignment of 64-bit integers
+    uint64_t f64_abi_align;         // ABI alignment of 64-bit floats
+    uint64_t aggregate_pref_align;  // Minimum preferred alignment of structs
 
     TargetPlatform()
     {}
@@ -28,11 +44,15 @@ struct TargetPlatform {
     uint64_t GetComptimeSizeOf(Type* type);
     uint64_t GetComptimeAlignOf(Type* type);
 
+    // InitLayoutModel sets the layout model for the target triple.
+    void InitLayoutModel();
+
 private:
-    llvm::Type* getLLVMType(Type* type);
+    TypeLayout getLayout(Type* type);
+    TypeLayout getScalarLayout(uint64_t size, uint64_t abi_align);
 };
 
 
 TargetPlatform& GetTargetPlatform();
 
-#endif
\ No newline at end of file
+#endif
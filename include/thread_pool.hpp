@@ -0,0 +1,26 @@
+#ifndef THREAD_POOL_H_INC
+#define THREAD_POOL_H_INC
+
+#include <functional>
+
+#include "base.hpp"
+
+// ParallelTask is a task run by ParallelFor.  worker_id is in the range [0,
+// n_workers) and uniquely identifies the thread running the task so that it
+// can be used to index per-worker state.  item is the index of the work item
+// to process.
+using ParallelTask = std::function<void(size_t worker_id, size_t item)>;
+
+// GetDefaultWorkerCount returns the number of workers to use when the user
+// does not explicitly specify a job count: one per hardware thread.
+size_t GetDefaultWorkerCount();
+
+// ParallelFor runs task once for every item in the range [0, n_items) using at
+// most n_workers threads (the calling thread counts as one of the workers).
+// Items are handed out dynamically in ascending order so that one slow item
+// doesn't hold up the rest.  If any task throws, no new items are started and
+// the first exception caught is rethrown on the calling thread once all the
+// workers have stopped.
+void ParallelFor(size_t n_workers, size_t n_items, const ParallelTask& task);
+
+#endif
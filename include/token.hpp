@@ -123,8 +123,11 @@ struct Token {
     // kind is the token's kind.
     TokenKind kind;
 
-    // value is the owned text/value of the token.
-    std::string value;
+    // value is the text of the token.  It is a view into the source buffer
+    // being lexed, so it is only valid for as long as that buffer is.  String
+    // and rune literals don't include their quotes and directives don't
+    // include their leading `#`.
+    std::string_view value;
 
     // span is the token's location in source text.
     TextSpan span;
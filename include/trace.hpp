@@ -0,0 +1,56 @@
+#ifndef TRACE_H_INC
+#define TRACE_H_INC
+
+#include "base.hpp"
+
+// TRACE_GRANULARITY_US is the minimum duration in microseconds of the spans of
+// fine-grained events (declarations and LLVM passes): shorter spans are
+// dropped so that the trace only shows the events that matter.
+#define TRACE_GRANULARITY_US 500
+
+// trace_enabled indicates whether spans are being recorded.  It is only
+// changed while no compilation is running.
+extern bool trace_enabled;
+
+// StartTrace discards any previously recorded spans and starts recording.
+void StartTrace();
+
+// FinishTrace stops recording and writes all the recorded spans to out_path in
+// the Chrome trace event format (viewable in chrome://tracing or Perfetto).
+void FinishTrace(const std::string& out_path);
+
+// BeginTraceSpan opens a new span on the current thread.  Spans are nested:
+// each call must be matched by a call to EndTraceSpan on the same thread.
+// detail is additional information about the span (eg. the module name).  If
+// the span lasts less than min_dur_us microseconds, it is not recorded.  This
+// must only be called if tracing is enabled.
+void BeginTraceSpan(std::string_view name, std::string_view detail = "", uint64_t min_dur_us = 0);
+
+// EndTraceSpan closes the innermost open span on the current thread.
+void EndTraceSpan();
+
+// TraceScope records a span covering its lifetime.  It does nothing if tracing
+// is disabled when it is created.
+class TraceScope {
+    bool active;
+
+public:
+    TraceScope(std::string_view name, std::string_view detail = "", uint64_t min_dur_us = 0)
+    : active(trace_enabled)
+    {
+        if (active) {
+            BeginTraceSpan(name, detail, min_dur_us);
+        }
+    }
+
+    ~TraceScope() {
+        if (active) {
+            EndTraceSpan();
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+#endif
@@ -54,20 +54,17 @@ struct Method {
     Type* signature;
     bool exported;
 
-    llvm::Value* llvm_value;
-
     Method(size_t parent_id_, std::string_view name_, Type* sig_, bool exported_)
     : parent_id(parent_id_)
     , decl_num(0)
     , name(name_)
     , signature(sig_)
     , exported(exported_)
-    , llvm_value(nullptr)
     {}
 };
 
 // MethodTable is a collection of methods keyed by name.
-typedef std::unordered_map<std::string_view, Method*> MethodTable;
+typedef NameMap<Method*> MethodTable;
 
 struct FactoryFunc {
     size_t parent_id;
@@ -76,14 +73,11 @@ struct FactoryFunc {
     Type* signature;
     bool exported;
 
-    llvm::Value* llvm_value;
-
     FactoryFunc(size_t parent_id_, Type* sig_, bool exported_)
     : parent_id(parent_id_)
     , decl_num(0)
     , signature(sig_)
     , exported(exported_)
-    , llvm_value(nullptr)
     {}
 };
 
@@ -127,7 +121,6 @@ struct Type {
         struct {
             std::span<StructField> fields;
             MapView<size_t> name_map;
-            llvm::Type* llvm_type;
         } ty_Struct;
         struct {
             MapView<uint64_t> tag_map;
@@ -1,6 +1,67 @@
 #include "arena.hpp"
 
-#define ARENA_CHUNK_SIZE ((8 * 1024 * 1024))
+#include <iostream>
+#include <atomic>
+#include <algorithm>
+
+// ARENA_MIN_RESERVE_SIZE is the smallest amount of virtual memory reserved for
+// a chunk: a single commit granule (see ARENA_COMMIT_SIZE).  When a reservation
+// fails, the arena retries with smaller ones down to this size and simply uses
+// more chunks.
+#define ARENA_MIN_RESERVE_SIZE ((2 * 1024 * 1024))
+
+// ARENA_LIMIT_SHARE is the fraction of the process's address space limit (eg.
+// set by ulimit -v) the first chunk of an arena may reserve.  The limit is
+// shared by all the arenas, so under one chunks start small and grow as their
+// arena does.
+#define ARENA_LIMIT_SHARE 256
+
+// arena_reserve_sizes is the amount of virtual memory reserved for each chunk
+// of an arena by tag.  Reserving address space is almost free, so on 64-bit
+// systems the chunks are large enough that an arena should never need more
+// than one.  The arenas which only exist once get the most room: there is an
+// AST and HIR arena per module and a scratch arena per thread.
+#if ARCH_64_BIT
+    #define ARENA_GiB ((1024ull * 1024 * 1024))
+
+    static const size_t arena_reserve_sizes[ARENA_TAGS_COUNT] {
+        ARENA_GiB / 4,  // ARENA_UNTAGGED
+        8 * ARENA_GiB,  // ARENA_GLOBAL
+        ARENA_GiB / 4,  // ARENA_AST
+        8 * ARENA_GiB,  // ARENA_CHECK
+        ARENA_GiB / 4,  // ARENA_HIR
+    };
+#else
+    #define ARENA_MiB ((1024 * 1024))
+
+    static const size_t arena_reserve_sizes[ARENA_TAGS_COUNT] {
+        16 * ARENA_MiB, // ARENA_UNTAGGED
+        64 * ARENA_MiB, // ARENA_GLOBAL
+        16 * ARENA_MiB, // ARENA_AST
+        64 * ARENA_MiB, // ARENA_CHECK
+        16 * ARENA_MiB, // ARENA_HIR
+    };
+#endif
+
+// ARENA_COMMIT_SIZE is the granularity in which the memory of a chunk is
+// committed as the arena grows.  It is a multiple of the page size (including
+// the size of huge pages).
+#define ARENA_COMMIT_SIZE ((2 * 1024 * 1024))
+
+// ARENA_HUGE_PAGE_MIN is the amount of memory an arena must commit before its
+// chunk is marked to use transparent huge pages: small arenas would only waste
+// memory with them.
+#define ARENA_HUGE_PAGE_MIN ((32 * 1024 * 1024))
+
+// ARENA_BLOCK_SIZE is the size of the blocks threads allocate from in
+// concurrent arenas.  Allocations larger than ARENA_BLOCK_MAX_ALLOC are
+// claimed directly from the arena's chunk.
+#define ARENA_BLOCK_SIZE ((64 * 1024))
+#define ARENA_BLOCK_MAX_ALLOC ((ARENA_BLOCK_SIZE / 8))
+
+// ARENA_BLOCK_CACHES is the number of concurrent arenas a thread can keep a
+// block of at once.
+#define ARENA_BLOCK_CACHES 4
 
 #if ARCH_64_BIT
     #define ARENA_ALIGN 8
@@ -8,7 +69,64 @@
     #define ARENA_ALIGN 4
 #endif
 
-#define max(a, b) ((a) < (b) ? b : a)
+static_assert(sizeof(ArenaChunk) % ARENA_ALIGN == 0, "arena chunk buffers must be aligned");
+
+// total_reserved is the amount of system memory held by all arenas, and
+// peak_total_reserved is the largest value it has had.  They are only updated
+// when chunks are allocated and freed so the atomics are cheap.
+static std::atomic<size_t> total_reserved { 0 };
+static std::atomic<size_t> peak_total_reserved { 0 };
+
+static void addTotalReserved(size_t size) {
+    size_t new_total = total_reserved.fetch_add(size) + size;
+
+    size_t peak = peak_total_reserved.load();
+    while (peak < new_total && !peak_total_reserved.compare_exchange_weak(peak, new_total)) {}
+}
+
+size_t GetArenaPeakReserved() {
+    return peak_total_reserved.load();
+}
+
+// next_cache_id is the next unused arena cache ID.  IDs are never reused so
+// that a thread's cached block can't be mistaken for a block of another arena.
+static std::atomic<uint64_t> next_cache_id { 1 };
+
+// ArenaBlockCache is a thread's current block in a concurrent arena.
+struct ArenaBlockCache {
+    uint64_t cache_id;
+    byte* next;
+    byte* end;
+};
+
+static thread_local ArenaBlockCache block_caches[ARENA_BLOCK_CACHES] {};
+static thread_local size_t next_evicted_cache = 0;
+
+static const char* arena_tag_names[ARENA_TAGS_COUNT] = {
+    "untagged",
+    "global",
+    "ast",
+    "check",
+    "hir",
+};
+
+// arenaOutOfMemory aborts the compiler when an arena can't get memory from the
+// OS.  Arena allocations are made all over the compiler, so there is no
+// sensible way to recover.
+[[ noreturn ]]
+static void arenaOutOfMemory(ArenaTag tag, size_t size) {
+    Panic("out of memory: failed to allocate {} bytes in the {} arena", size, arena_tag_names[tag]);
+}
+
+/* -------------------------------------------------------------------------- */
+
+Arena::Arena(ArenaTag tag, bool concurrent)
+: curr_chunk(nullptr)
+, tag(tag)
+, stats({})
+, concurrent(concurrent)
+, cache_id(next_cache_id++)
+{}
 
 Arena::~Arena() {
     Release();
@@ -16,7 +134,14 @@ Arena::~Arena() {
 
 Arena::Arena(Arena&& arena) {
     curr_chunk = arena.curr_chunk;
+    tag = arena.tag;
+    stats = arena.stats;
+    concurrent = arena.concurrent;
+    cache_id = arena.cache_id;
+
     arena.curr_chunk = nullptr;
+    arena.stats = {};
+    arena.cache_id = next_cache_id++;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -24,6 +149,8 @@ Arena::Arena(Arena&& arena) {
 void* Arena::Alloc(size_t size) {
     if (size == 0) {
         return nullptr;
+    } else if (concurrent) {
+        return allocConcurrent(size);
     }
 
     size_t fwd_offset = 0;
@@ -33,29 +160,280 @@ void* Arena::Alloc(size_t size) {
         full_size += fwd_offset;
     }
 
-    if (curr_chunk == nullptr || (curr_chunk->n_used + full_size > curr_chunk->n_alloc)) {
+    if (curr_chunk == nullptr || (curr_chunk->n_used + full_size > curr_chunk->n_reserve)) {
         full_size = alignSize(size);
         fwd_offset = 0;
 
-        size_t chunk_size = max(full_size + sizeof(ArenaChunk), ARENA_CHUNK_SIZE);
-
-        ArenaChunk* new_chunk = (ArenaChunk*)sysAlloc(nullptr, chunk_size);
-        if (new_chunk == nullptr) {
-            return nullptr;
+        if (!newChunk(full_size)) {
+            arenaOutOfMemory(tag, size);
         }
+    }
 
-        new_chunk->n_alloc = chunk_size - sizeof(ArenaChunk);
-        new_chunk->prev = curr_chunk;
-
-        curr_chunk = new_chunk;
+    if (curr_chunk->n_used + full_size > curr_chunk->n_alloc) {
+        if (!commitChunk(curr_chunk, curr_chunk->n_used + full_size)) {
+            arenaOutOfMemory(tag, size);
+        }
     }
 
+    stats.n_requested += size;
+    stats.n_align_waste += full_size - size;
+
     byte* ptr = curr_chunk->data + curr_chunk->n_used;
     curr_chunk->n_used += full_size;
 
     return ptr + fwd_offset;
 }
 
+void* Arena::allocConcurrent(size_t size) {
+    size_t full_size = alignSize(size);
+    if (full_size > ARENA_BLOCK_MAX_ALLOC) {
+        return allocShared(full_size);
+    }
+
+    auto* cache = findBlockCache();
+
+    // The rest of an evicted block is simply wasted.
+    if (cache == nullptr) {
+        cache = &block_caches[next_evicted_cache];
+        next_evicted_cache = (next_evicted_cache + 1) % ARENA_BLOCK_CACHES;
+
+        cache->cache_id = cache_id;
+        cache->next = nullptr;
+        cache->end = nullptr;
+    }
+
+    if ((size_t)(cache->end - cache->next) < full_size) {
+        auto* block = (byte*)allocShared(ARENA_BLOCK_SIZE);
+        cache->next = block;
+        cache->end = block + ARENA_BLOCK_SIZE;
+    }
+
+    byte* ptr = cache->next;
+    cache->next += full_size;
+    return ptr;
+}
+
+ArenaBlockCache* Arena::findBlockCache() {
+    for (auto& block_cache : block_caches) {
+        if (block_cache.cache_id == cache_id) {
+            return &block_cache;
+        }
+    }
+
+    return nullptr;
+}
+
+void* Arena::allocShared(size_t size) {
+    // The current chunk and its committed size are only changed while holding
+    // the mutex, but they are read without it.  Chunks are never freed while
+    // the arena is in use, so a thread reading an old chunk just retries.
+    while (true) {
+        auto* chunk = std::atomic_ref(curr_chunk).load(std::memory_order_acquire);
+        if (chunk != nullptr) {
+            size_t offset = std::atomic_ref(chunk->n_used).fetch_add(size, std::memory_order_relaxed);
+            if (offset + size <= chunk->n_reserve) {
+                if (offset + size > std::atomic_ref(chunk->n_alloc).load(std::memory_order_acquire)) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!commitChunk(chunk, offset + size)) {
+                        arenaOutOfMemory(tag, size);
+                    }
+                }
+
+                std::atomic_ref(stats.n_requested).fetch_add(size, std::memory_order_relaxed);
+                return chunk->data + offset;
+            }
+        }
+
+        // The chunk is full: only the first thread to get the lock adds a new
+        // chunk, and the others retry in it.
+        std::lock_guard<std::mutex> lock(mutex);
+        if (curr_chunk == chunk && !newChunk(size)) {
+            arenaOutOfMemory(tag, size);
+        }
+    }
+}
+
+bool Arena::newChunk(size_t min_size) {
+    static const size_t limit_reserve_size = alignCommitSize(sysGetAddressSpaceLimit() / ARENA_LIMIT_SHARE);
+
+    // Each chunk reserves at most double the last one so that an arena which
+    // had to start small grows to its full reservation size gradually.
+    size_t chunk_size = std::min(arena_reserve_sizes[tag], limit_reserve_size);
+    if (curr_chunk != nullptr) {
+        chunk_size = std::min(arena_reserve_sizes[tag], 2 * (curr_chunk->n_reserve + sizeof(ArenaChunk)));
+    }
+
+    // Oversized allocations get a chunk of their own.
+    size_t min_chunk_size = std::max(alignCommitSize(min_size + sizeof(ArenaChunk)), (size_t)ARENA_MIN_RESERVE_SIZE);
+    chunk_size = std::max(chunk_size, min_chunk_size);
+
+    ArenaChunk* new_chunk;
+    while ((new_chunk = (ArenaChunk*)sysReserve(chunk_size)) == nullptr) {
+        if (chunk_size == min_chunk_size) {
+            return false;
+        }
+
+        chunk_size = std::max(alignCommitSize(chunk_size / 2), min_chunk_size);
+    }
+
+    // The chunk header has to be committed before it can be written.
+    if (!sysCommit(new_chunk, ARENA_COMMIT_SIZE)) {
+        sysFree(new_chunk, chunk_size);
+        return false;
+    }
+
+    new_chunk->n_used = 0;
+    new_chunk->n_alloc = ARENA_COMMIT_SIZE - sizeof(ArenaChunk);
+    new_chunk->n_reserve = chunk_size - sizeof(ArenaChunk);
+    new_chunk->prev = curr_chunk;
+    new_chunk->huge_pages = false;
+
+    // In concurrent arenas, n_used can overshoot the end of a full chunk.
+    if (curr_chunk != nullptr) {
+        size_t n_used = std::atomic_ref(curr_chunk->n_used).load(std::memory_order_relaxed);
+        if (n_used < curr_chunk->n_alloc) {
+            stats.n_tail_waste += curr_chunk->n_alloc - n_used;
+        }
+    }
+
+    stats.n_chunks++;
+    stats.n_reserved += ARENA_COMMIT_SIZE;
+    stats.peak_reserved = std::max(stats.peak_reserved, stats.n_reserved);
+    addTotalReserved(ARENA_COMMIT_SIZE);
+
+    std::atomic_ref(curr_chunk).store(new_chunk, std::memory_order_release);
+    return true;
+}
+
+bool Arena::commitChunk(ArenaChunk* chunk, size_t min_size) {
+    // Another thread may have already committed the memory.
+    if (min_size <= chunk->n_alloc) {
+        return true;
+    }
+
+    size_t old_commit_size = chunk->n_alloc + sizeof(ArenaChunk);
+    size_t new_commit_size = alignCommitSize(min_size + sizeof(ArenaChunk));
+
+    // Commit in ever larger steps so that large arenas don't have to make a
+    // system call for every commit granule.
+    new_commit_size = std::max(new_commit_size, alignCommitSize(old_commit_size + old_commit_size / 4));
+
+    size_t chunk_size = chunk->n_reserve + sizeof(ArenaChunk);
+    if (new_commit_size > chunk_size) {
+        new_commit_size = chunk_size;
+    }
+
+    byte* chunk_start = (byte*)chunk;
+    size_t n_commit = new_commit_size - old_commit_size;
+    if (!sysCommit(chunk_start + old_commit_size, n_commit)) {
+        return false;
+    }
+
+    std::atomic_ref(chunk->n_alloc).store(new_commit_size - sizeof(ArenaChunk), std::memory_order_release);
+
+    stats.n_reserved += n_commit;
+    stats.peak_reserved = std::max(stats.peak_reserved, stats.n_reserved);
+    addTotalReserved(n_commit);
+
+    if (!chunk->huge_pages && new_commit_size >= ARENA_HUGE_PAGE_MIN) {
+        sysAdviseHugePages(chunk_start, chunk_size);
+        chunk->huge_pages = true;
+    }
+
+    return true;
+}
+
+bool Arena::Contains(const void* ptr) const {
+    // Chunks are only ever added while the arena is in use, and the chunk
+    // list is linked before it is published so this is safe to call while
+    // other threads are allocating.
+    auto* chunk = std::atomic_ref(const_cast<ArenaChunk*&>(curr_chunk)).load(std::memory_order_acquire);
+    for (; chunk != nullptr; chunk = chunk->prev) {
+        if (ptr >= chunk->data && ptr < chunk->data + chunk->n_reserve) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+ArenaMark Arena::Mark() const {
+    Assert(!concurrent, "cannot mark a concurrent arena");
+
+    return {
+        curr_chunk,
+        curr_chunk == nullptr ? 0 : curr_chunk->n_used,
+        stats.n_requested,
+        stats.n_align_waste,
+        stats.n_tail_waste
+    };
+}
+
+void Arena::Rewind(const ArenaMark& mark) {
+    Assert(!concurrent, "cannot rewind a concurrent arena");
+
+    if (curr_chunk == nullptr) {
+        return;
+    }
+
+    // The first chunk is kept even if it was made after the mark so that
+    // rewinding a scratch arena doesn't return its memory to the OS.
+    while (curr_chunk != mark.chunk && curr_chunk->prev != nullptr) {
+        auto* prev_chunk = curr_chunk->prev;
+        freeChunk(curr_chunk);
+        curr_chunk = prev_chunk;
+    }
+
+    curr_chunk->n_used = curr_chunk == mark.chunk ? mark.n_used : 0;
+
+    stats.n_requested = mark.n_requested;
+    stats.n_align_waste = mark.n_align_waste;
+    stats.n_tail_waste = mark.n_tail_waste;
+}
+
+bool Arena::TryExtend(void* ptr, size_t old_size, size_t new_size) {
+    if (ptr == nullptr || new_size < old_size) {
+        return false;
+    }
+
+    if (concurrent) {
+        // Threads' blocks are bump allocated in aligned steps.
+        auto* cache = findBlockCache();
+        byte* start = (byte*)ptr;
+        if (cache == nullptr || cache->next != start + alignSize(old_size)) {
+            return false;
+        }
+
+        if ((size_t)(cache->end - start) < alignSize(new_size)) {
+            return false;
+        }
+
+        cache->next = start + alignSize(new_size);
+        return true;
+    }
+
+    if (curr_chunk == nullptr || curr_chunk->data + curr_chunk->n_used != (byte*)ptr + old_size) {
+        return false;
+    }
+
+    size_t n_used = curr_chunk->n_used + (new_size - old_size);
+    if (n_used > curr_chunk->n_reserve) {
+        return false;
+    }
+
+    if (n_used > curr_chunk->n_alloc && !commitChunk(curr_chunk, n_used)) {
+        return false;
+    }
+
+    curr_chunk->n_used = n_used;
+    stats.n_requested += new_size - old_size;
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
 size_t Arena::computeFwdOffset() {
     size_t iptr = (size_t)(curr_chunk->data + curr_chunk->n_used);
     
@@ -73,15 +451,28 @@ size_t Arena::alignSize(size_t size) {
     return size + (ARENA_ALIGN - size % ARENA_ALIGN);
 }
 
+size_t Arena::alignCommitSize(size_t size) {
+    if (size % ARENA_COMMIT_SIZE == 0)
+        return size;
+
+    return size + (ARENA_COMMIT_SIZE - size % ARENA_COMMIT_SIZE);
+}
+
 /* -------------------------------------------------------------------------- */
 
 void Arena::Release() {
     ArenaChunk* prev_chunk;
     while (curr_chunk != nullptr) {
         prev_chunk = curr_chunk->prev;
-        sysFree(curr_chunk);
+        freeChunk(curr_chunk);
         curr_chunk = prev_chunk;
     }
+
+    cache_id = next_cache_id++;
+
+    stats.n_requested = 0;
+    stats.n_align_waste = 0;
+    stats.n_tail_waste = 0;
 }
 
 void Arena::Reset() {
@@ -90,12 +481,88 @@ void Arena::Reset() {
 
     auto* prev_chunk = curr_chunk->prev;
     while (prev_chunk != nullptr) {
-        sysFree(curr_chunk);
+        freeChunk(curr_chunk);
         curr_chunk = prev_chunk;
         prev_chunk = curr_chunk->prev;
     }
 
     curr_chunk->n_used = 0;
+    cache_id = next_cache_id++;
+
+    stats.n_requested = 0;
+    stats.n_align_waste = 0;
+    stats.n_tail_waste = 0;
+}
+
+void Arena::freeChunk(ArenaChunk* chunk) {
+    size_t commit_size = chunk->n_alloc + sizeof(ArenaChunk);
+
+    stats.n_chunks--;
+    stats.n_reserved -= commit_size;
+    total_reserved.fetch_sub(commit_size);
+
+    sysFree(chunk, chunk->n_reserve + sizeof(ArenaChunk));
+}
+
+/* -------------------------------------------------------------------------- */
+
+// scratch_arena is the current thread's scratch arena.
+static thread_local Arena scratch_arena;
+
+Arena& GetScratchArena() {
+    return scratch_arena;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ArenaStats::Add(const ArenaStats& other) {
+    n_requested += other.n_requested;
+    n_align_waste += other.n_align_waste;
+    n_tail_waste += other.n_tail_waste;
+    n_chunks += other.n_chunks;
+    n_reserved += other.n_reserved;
+    peak_reserved += other.peak_reserved;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ArenaReport::Add(const Arena& arena) {
+    tag_stats[arena.GetTag()].Add(arena.GetStats());
+}
+
+// toKiB converts a size in bytes to KiB for display.
+static double toKiB(size_t size) {
+    return (double)size / 1024.0;
+}
+
+void ArenaReport::Print(const char* phase) {
+    std::cout << std::format("[MEMORY] {} (KiB)\n", phase);
+    std::cout << std::format(
+        "    {:<10} {:>7} {:>12} {:>12} {:>12} {:>12} {:>12}\n",
+        "arena", "chunks", "committed", "requested", "align waste", "tail waste", "peak"
+    );
+
+    ArenaStats total {};
+    for (size_t i = 0; i < ARENA_TAGS_COUNT; i++) {
+        auto& stats = tag_stats[i];
+        if (stats.peak_reserved == 0) {
+            continue;
+        }
+
+        std::cout << std::format(
+            "    {:<10} {:>7} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.1f}\n",
+            arena_tag_names[i], stats.n_chunks, toKiB(stats.n_reserved), toKiB(stats.n_requested),
+            toKiB(stats.n_align_waste), toKiB(stats.n_tail_waste), toKiB(stats.peak_reserved)
+        );
+
+        total.Add(stats);
+    }
+
+    std::cout << std::format(
+        "    {:<10} {:>7} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.1f}\n",
+        "total", total.n_chunks, toKiB(total.n_reserved), toKiB(total.n_requested),
+        toKiB(total.n_align_waste), toKiB(total.n_tail_waste), toKiB(GetArenaPeakReserved())
+    );
 }
 
 /* -------------------------------------------------------------------------- */
@@ -105,13 +572,59 @@ void Arena::Reset() {
 	#define WIN32_MEAN_AND_LEAN 1
     #include <Windows.h>
 
-    void* Arena::sysAlloc(void* start, size_t size) {
-        return VirtualAlloc(start, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    void* Arena::sysReserve(size_t size) {
+        return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
     }
 
-    bool Arena::sysFree(void* block) {
+    bool Arena::sysCommit(void* start, size_t size) {
+        return VirtualAlloc(start, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+    }
+
+    bool Arena::sysFree(void* block, size_t) {
         return VirtualFree(block, 0, MEM_RELEASE) > 0;
     }
+
+    void Arena::sysAdviseHugePages(void*, size_t) {
+        // Large pages on Windows require a special privilege and must be
+        // allocated up front, so they aren't used.
+    }
+
+    size_t Arena::sysGetAddressSpaceLimit() {
+        // Reservations on Windows are only limited by the address space.
+        return SIZE_MAX;
+    }
 #else
-    #error non-windows arena allocator not yet implemented
-#endif
\ No newline at end of file
+    #include <sys/mman.h>
+    #include <sys/resource.h>
+
+    void* Arena::sysReserve(size_t size) {
+        // The reserved range is not backed by memory (or swap) until it is
+        // committed.
+        void* block = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        return block == MAP_FAILED ? nullptr : block;
+    }
+
+    bool Arena::sysCommit(void* start, size_t size) {
+        return mprotect(start, size, PROT_READ | PROT_WRITE) == 0;
+    }
+
+    bool Arena::sysFree(void* block, size_t size) {
+        return munmap(block, size) == 0;
+    }
+
+    void Arena::sysAdviseHugePages(void* start, size_t size) {
+        #ifdef MADV_HUGEPAGE
+            // This is only a hint: it is fine if it fails.
+            madvise(start, size, MADV_HUGEPAGE);
+        #endif
+    }
+
+    size_t Arena::sysGetAddressSpaceLimit() {
+        struct rlimit limit;
+        if (getrlimit(RLIMIT_AS, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY || limit.rlim_cur > SIZE_MAX) {
+            return SIZE_MAX;
+        }
+
+        return (size_t)limit.rlim_cur;
+    }
+#endif
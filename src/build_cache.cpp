@@ -0,0 +1,51 @@
+#include "build_cache.hpp"
+
+#include <filesystem>
+#include <random>
+
+namespace fs = std::filesystem;
+
+BuildCache::BuildCache(const std::string& cache_dir)
+: cache_dir(cache_dir)
+{}
+
+void BuildCache::Open() {
+    std::error_code ec;
+    fs::create_directories(cache_dir, ec);
+    enabled = !ec;
+}
+
+std::string BuildCache::GetObjectPath(const std::string& key, const std::string& ext) const {
+    return (fs::path(cache_dir) / fs::path(key + ext)).string();
+}
+
+bool BuildCache::Contains(const std::string& key, const std::string& ext) const {
+    if (!enabled) {
+        return false;
+    }
+
+    std::error_code ec;
+    return fs::is_regular_file(GetObjectPath(key, ext), ec);
+}
+
+void BuildCache::Store(const std::string& key, const std::string& ext, const std::string& obj_path) {
+    if (!enabled) {
+        return;
+    }
+
+    // The object is copied to a temporary file first and then renamed into
+    // place so that another compiler sharing the cache never sees a partially
+    // written object.
+    auto cached_path = GetObjectPath(key, ext);
+    auto temp_path = std::format("{}.{:x}.tmp", cached_path, std::random_device{}());
+
+    std::error_code ec;
+    fs::copy_file(obj_path, temp_path, fs::copy_options::overwrite_existing, ec);
+    if (!ec) {
+        fs::rename(temp_path, cached_path, ec);
+    }
+
+    if (ec) {
+        fs::remove(temp_path, ec);
+    }
+}
@@ -1,6 +1,7 @@
 #include "checker.hpp"
 
 #include "target.hpp"
+#include "stats.hpp"
 
 uint64_t Checker::checkComptimeSize(AstNode* node) {
     comptime_depth++;
@@ -23,6 +24,8 @@ uint64_t Checker::checkComptimeSize(AstNode* node) {
 /* -------------------------------------------------------------------------- */
 
 ConstValue* Checker::evalComptime(HirExpr* node) {
+    CountStat(STAT_COMPTIME_EVALS);
+
     ConstValue* value;
 
     switch (node->kind) {
@@ -72,15 +75,13 @@ ConstValue* Checker::evalComptime(HirExpr* node) {
     case HIR_ARRAY_LIT: {
         value = allocComptime(CONST_ARRAY);
 
-        std::vector<ConstValue*> elems;
+        ArenaList<ConstValue*> elems(arena, node->ir_ArrayLit.items.size());
         for (auto* helem : node->ir_ArrayLit.items) {
-            elems.push_back(evalComptime(helem));
+            elems.Push(evalComptime(helem));
         }
 
-        value->v_array.elems = arena.MoveVec(std::move(elems));
+        value->v_array.elems = elems.Freeze();
         value->v_array.elem_type = node->type->Inner()->ty_Slice.elem_type->Inner();
-        value->v_array.mod_id = mod.id;
-        value->v_array.alloc_loc = nullptr;
     } break;
     case HIR_STRUCT_LIT:
         value = evalComptimeStructLit(node);
@@ -157,8 +158,6 @@ ConstValue* Checker::evalComptime(HirExpr* node) {
     case HIR_STRING_LIT:
         value = allocComptime(CONST_STRING);
         value->v_str.value = node->ir_String.value;
-        value->v_str.mod_id = mod.id;
-        value->v_str.alloc_loc = nullptr;
         break;
     case HIR_NULL:
         value = getComptimeNull(node->type);
@@ -332,17 +331,15 @@ ConstValue* Checker::evalComptimeCast(HirExpr* node) {
         if (src->kind == CONST_STRING) {
             value = allocComptime(CONST_ARRAY);
 
-            std::vector<ConstValue*> values;
+            ArenaList<ConstValue*> values(arena, src->v_str.value.size());
             for (auto ch : src->v_str.value) {
                 auto* ch_value = allocComptime(CONST_U8);
                 ch_value->v_u8 = ch;
-                values.push_back(ch_value);
+                values.Push(ch_value);
             }
 
-            value->v_array.elems = arena.MoveVec(std::move(values));
+            value->v_array.elems = values.Freeze();
             value->v_array.elem_type = &prim_u8_type;
-            value->v_array.mod_id = mod.id;
-            value->v_array.alloc_loc = nullptr;
         } else if (src->kind == CONST_ARRAY || src->kind == CONST_ZERO_ARRAY) {
             value = src;
         }
@@ -365,8 +362,6 @@ ConstValue* Checker::evalComptimeCast(HirExpr* node) {
             Panic("unimplemented comptime cast");
         }
 
-        value->v_str.mod_id = mod.id;
-        value->v_str.alloc_loc = nullptr;
         break;
     case TYPE_ENUM:
         value = allocComptime(CONST_ENUM);
@@ -739,8 +734,6 @@ ConstValue* Checker::evalComptimeStructLit(HirExpr* node) {
 
     auto* value = allocComptime(CONST_STRUCT);
     value->v_struct.fields = arena.MoveVec(std::move(field_values));
-    value->v_struct.mod_id = mod.id;
-    value->v_struct.alloc_loc = nullptr;
     return value;
 }
 
@@ -794,8 +787,6 @@ ConstValue* Checker::evalComptimeSlice(HirExpr* node) {
         value = allocComptime(CONST_ARRAY);
         value->v_array.elems = array->v_array.elems.subspan(start_index, end_index - start_index);
         value->v_array.elem_type = array->v_array.elem_type;
-        value->v_array.mod_id = mod.id;
-        value->v_array.alloc_loc = nullptr;
     } else if (array->kind == CONST_ZERO_ARRAY) {
         auto start_index = 
             node->ir_Slice.start_index 
@@ -813,8 +804,6 @@ ConstValue* Checker::evalComptimeSlice(HirExpr* node) {
         value = allocComptime(CONST_ZERO_ARRAY);
         value->v_zarr.num_elems = end_index - start_index;
         value->v_zarr.elem_type = array->v_zarr.elem_type;
-        value->v_zarr.mod_id = mod.id;
-        value->v_zarr.alloc_loc = nullptr;
     } else if (array->kind == CONST_STRING) {
          auto start_index = 
             node->ir_Slice.start_index 
@@ -831,8 +820,6 @@ ConstValue* Checker::evalComptimeSlice(HirExpr* node) {
 
         value = allocComptime(CONST_STRING);
         value->v_str.value = array->v_str.value.substr(start_index, end_index);
-        value->v_str.mod_id = mod.id;
-        value->v_str.alloc_loc = nullptr;
     } else {
         Panic("invalid comptime slice expr");
     }
@@ -956,32 +943,24 @@ ConstValue* Checker::getComptimeNull(Type* type) {
         value = allocComptime(CONST_ZERO_ARRAY);
         value->v_zarr.num_elems = type->ty_Array.len;
         value->v_zarr.elem_type = type->ty_Array.elem_type;
-        value->v_zarr.mod_id = mod.id;
-        value->v_zarr.alloc_loc = nullptr;
         break;
     case TYPE_SLICE:
         value = allocComptime(CONST_ARRAY);
         value->v_array.elems = {};
         value->v_array.elem_type = type->ty_Slice.elem_type->Inner();
-        value->v_array.mod_id = mod.id;
-        value->v_array.alloc_loc = nullptr;
         break;
     case TYPE_STRING:
         value = allocComptime(CONST_STRING);
         value->v_str.value = "";
-        value->v_str.mod_id = mod.id;
-        value->v_str.alloc_loc = nullptr;
         break;
     case TYPE_STRUCT: {
-        std::vector<ConstValue*> field_values;
+        ArenaList<ConstValue*> field_values(arena, type->ty_Struct.fields.size());
         for (auto& field : type->ty_Struct.fields) {
-            field_values.push_back(getComptimeNull(field.type));
+            field_values.Push(getComptimeNull(field.type));
         }
 
         value = allocComptime(CONST_STRUCT);
-        value->v_struct.fields = arena.MoveVec(std::move(field_values));
-        value->v_struct.mod_id = mod.id;
-        value->v_struct.alloc_loc = nullptr;
+        value->v_struct.fields = field_values.Freeze();
     } break;
     default:
         Panic("comptime null not implemented for type {}", (int)type->kind);
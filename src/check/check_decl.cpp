@@ -48,13 +48,13 @@ HirDecl* Checker::checkFuncDecl(Decl* decl) {
     auto* node = decl->ast_decl;
     auto* symbol = node->an_Func.symbol;
 
-    std::vector<Symbol*> params;
+    std::span<Symbol*> params;
     auto* func_type = checkFuncSignature(node->an_Func.func_type, params);
     symbol->type = func_type;
 
     auto* hfunc = allocDecl(HIR_FUNC, node->span);
     hfunc->ir_Func.symbol = symbol;
-    hfunc->ir_Func.params = arena.MoveVec(std::move(params));
+    hfunc->ir_Func.params = params;
     hfunc->ir_Func.return_type = func_type->ty_Func.return_type;
     hfunc->ir_Func.body = nullptr;
 
@@ -76,12 +76,11 @@ HirDecl* Checker::checkMethodDecl(Decl* decl) {
         }
     } 
 
-    auto& mtable = getMethodTable(bind_type);
-    if (mtable.contains(amethod.name)) {
+    if (findMethod(bind_type, amethod.name) != nullptr) {
         fatal(amethod.name_span, "type {} has multiple methods named {}", bind_type->ToString(), amethod.name);
     }    
 
-    std::vector<Symbol*> params;
+    std::span<Symbol*> params;
     auto* func_type = checkFuncSignature(amethod.func_type, params);
 
     auto* method = arena.New<Method>(
@@ -90,12 +89,18 @@ HirDecl* Checker::checkMethodDecl(Decl* decl) {
         func_type,
         decl->flags & DECL_EXPORTED
     );
-    mtable.emplace(amethod.name, method);
+
+    if (bind_type->ty_Named.mod_id == mod.id) {
+        getMethodTable(bind_type).emplace(amethod.name, method);
+    } else {
+        foreign_mtables[bind_type].emplace(amethod.name, method);
+        foreign_bindings.push_back({ bind_type, method, nullptr, decl->file_num, amethod.name_span });
+    }
 
     auto* hmethod = allocDecl(HIR_METHOD, decl->ast_decl->span);
     hmethod->ir_Method.bind_type = bind_type;
     hmethod->ir_Method.method = method;
-    hmethod->ir_Method.params = arena.MoveVec(std::move(params));
+    hmethod->ir_Method.params = params;
     hmethod->ir_Method.return_type = func_type->ty_Func.return_type;
     hmethod->ir_Method.body = nullptr;
     return hmethod;
@@ -109,11 +114,11 @@ HirDecl* Checker::checkFactoryDecl(Decl* decl) {
 
     Assert(bind_type->kind == TYPE_NAMED || bind_type->kind == TYPE_ALIAS, "non-named method bind type");
 
-    if (bind_type->ty_Named.factory != nullptr) {
+    if (findFactory(bind_type) != nullptr) {
         fatal(afact.bind_type->span, "multiple factory functions defined for type {}", bind_type->ToString());
     }
 
-    std::vector<Symbol*> params;
+    std::span<Symbol*> params;
     auto* func_type = checkFuncSignature(afact.func_type, params);
 
     auto* factory = arena.New<FactoryFunc>(
@@ -121,21 +126,30 @@ HirDecl* Checker::checkFactoryDecl(Decl* decl) {
         func_type,
         decl->flags & DECL_EXPORTED
     );
-    bind_type->ty_Named.factory = factory;
+
+    if (bind_type->ty_Named.mod_id == mod.id) {
+        bind_type->ty_Named.factory = factory;
+    } else {
+        foreign_factories[bind_type] = factory;
+        foreign_bindings.push_back({ bind_type, nullptr, factory, decl->file_num, afact.bind_type->span });
+    }
 
     auto* hfact = allocDecl(HIR_FACTORY, decl->ast_decl->span);
     hfact->ir_Factory.bind_type = bind_type;
     hfact->ir_Factory.func = factory;
-    hfact->ir_Factory.params = arena.MoveVec(std::move(params));
+    hfact->ir_Factory.params = params;
     hfact->ir_Factory.return_type = func_type->ty_Func.return_type;
     hfact->ir_Factory.body = nullptr;
     return hfact;
 }
 
-Type* Checker::checkFuncSignature(AstNode* node, std::vector<Symbol*>& params) {
+Type* Checker::checkFuncSignature(AstNode* node, std::span<Symbol*>& params) {
     auto& afunc_type = node->an_TypeFunc;
 
-    std::vector<Type*> param_types;
+    // The number of parameters is known up front so the lists are built in
+    // place in the arena.
+    ArenaList<Type*> param_types(arena, afunc_type.params.size());
+    ArenaList<Symbol*> param_list(arena, afunc_type.params.size());
     for (auto& aparam : afunc_type.params) {
         auto* param_type = checkTypeLabel(aparam.type, false);
         auto* param = arena.New<Symbol>(
@@ -147,8 +161,8 @@ Type* Checker::checkFuncSignature(AstNode* node, std::vector<Symbol*>& params) {
             param_type
         );
 
-        param_types.push_back(param_type);
-        params.push_back(param);
+        param_types.Push(param_type);
+        param_list.Push(param);
     }
 
     Type* return_type;
@@ -159,7 +173,8 @@ Type* Checker::checkFuncSignature(AstNode* node, std::vector<Symbol*>& params) {
     }
 
     auto* func_type = allocType(TYPE_FUNC);
-    func_type->ty_Func.param_types = arena.MoveVec(std::move(param_types));
+    func_type->ty_Func.param_types = param_types.Freeze();
+    params = param_list.Freeze();
     func_type->ty_Func.return_type = return_type;
     return func_type;
 }
@@ -171,28 +186,89 @@ MethodTable& Checker::getMethodTable(Type* bind_type) {
         auto mnode = std::make_unique<Module::MtableNode>();
         auto* mtable = &mnode->mtable;
 
+        Module* owner_mod = nullptr;
         if (bind_type->ty_Named.mod_id == mod.id) {
-            mnode->next = std::move(mod.mtable_list);
-            mod.mtable_list = std::move(mnode);
+            owner_mod = &mod;
         } else {
-            Module* dep_mod = nullptr;
             for (auto& dep : mod.deps) {
-                if (dep.id == mod.id) {
-                    dep_mod = dep.mod;
+                if (dep.mod->id == bind_type->ty_Named.mod_id) {
+                    owner_mod = dep.mod;
                     break;
                 }
             }
-
-            mnode->next = std::move(dep_mod->mtable_list);
-            dep_mod->mtable_list = std::move(mnode);
         }
 
+        Assert(owner_mod != nullptr, "method bind type defined outside of module dependencies");
+        mnode->next = std::move(owner_mod->mtable_list);
+        owner_mod->mtable_list = std::move(mnode);
+
         bind_type->ty_Named.methods = mtable;
     }
 
     return *bind_type->ty_Named.methods;
 }
 
+Method* Checker::findMethod(Type* bind_type, std::string_view method_name) {
+    if (bind_type->ty_Named.methods != nullptr) {
+        auto it = bind_type->ty_Named.methods->find(method_name);
+        if (it != bind_type->ty_Named.methods->end()) {
+            return it->second;
+        }
+    }
+
+    // Body tasks see the foreign bindings of the checker that forked them.
+    auto& foreign_mtables = parent ? parent->foreign_mtables : this->foreign_mtables;
+    auto ft_it = foreign_mtables.find(bind_type);
+    if (ft_it != foreign_mtables.end()) {
+        auto it = ft_it->second.find(method_name);
+        if (it != ft_it->second.end()) {
+            return it->second;
+        }
+    }
+
+    return nullptr;
+}
+
+FactoryFunc* Checker::findFactory(Type* bind_type) {
+    if (bind_type->ty_Named.factory != nullptr) {
+        return bind_type->ty_Named.factory;
+    }
+
+    auto& foreign_factories = parent ? parent->foreign_factories : this->foreign_factories;
+    auto it = foreign_factories.find(bind_type);
+    if (it != foreign_factories.end()) {
+        return it->second;
+    }
+
+    return nullptr;
+}
+
+void Checker::MergeForeignBindings() {
+    for (auto& binding : foreign_bindings) {
+        src_file = &mod.files[binding.file_num];
+        auto* bind_type = binding.bind_type;
+
+        // Modules checked alongside each other can't see each other's foreign
+        // bindings, so conflicts between them are only caught here.
+        if (binding.method) {
+            auto& mtable = getMethodTable(bind_type);
+            if (mtable.contains(binding.method->name)) {
+                error(binding.span, "type {} has multiple methods named {}", bind_type->ToString(), binding.method->name);
+            } else {
+                mtable.emplace(binding.method->name, binding.method);
+            }
+        } else if (bind_type->ty_Named.factory != nullptr) {
+            error(binding.span, "multiple factory functions defined for type {}", bind_type->ToString());
+        } else {
+            bind_type->ty_Named.factory = binding.factory;
+        }
+    }
+
+    foreign_bindings.clear();
+    foreign_mtables.clear();
+    foreign_factories.clear();
+}
+
 /* -------------------------------------------------------------------------- */
 
 HirDecl* Checker::checkGlobalVar(Decl* decl) {
@@ -225,6 +301,14 @@ HirDecl* Checker::checkGlobalVar(Decl* decl) {
         hgvar->ir_GlobalVar.const_init = is_comptime_expr ? evalComptime(hinit) : nullptr;
     }
 
+    // Global variables are always stored in memory, so code generation (both
+    // of this module and of the modules importing it) must treat them as
+    // variables.  This is settled here since symbols must not change once
+    // modules are generated in parallel.
+    if (symbol->flags & SYM_CONST) {
+        symbol->flags ^= SYM_VAR | SYM_CONST;
+    }
+
     symbol->type = type;
     return hgvar;
 }
@@ -395,26 +479,25 @@ Type* Checker::checkTypeLabel(AstNode* node, bool should_expand) {
         return slice_type;
     } break;
     case AST_TYPE_STRUCT: {
-        std::vector<StructField> fields;
-        std::unordered_map<std::string_view, size_t> name_map;
+        ArenaList<StructField> fields(arena, node->an_TypeStruct.fields.size());
+        NameMap<size_t> name_map;
 
         size_t i = 0;
         for (auto& afield : node->an_TypeStruct.fields) {
             auto* field_type = checkTypeLabel(afield.type, true);
 
-            fields.emplace_back(afield.name, field_type, afield.exported);
+            fields.Emplace(afield.name, field_type, afield.exported);
             name_map.emplace(afield.name, i++);
         }
 
         auto* struct_type = allocType(TYPE_STRUCT);
-        struct_type->ty_Struct.fields = arena.MoveVec(std::move(fields));
+        struct_type->ty_Struct.fields = fields.Freeze();
         struct_type->ty_Struct.name_map = MapView(arena, std::move(name_map));
-        struct_type->ty_Struct.llvm_type = nullptr;
 
         return struct_type;
     } break; 
     case AST_TYPE_ENUM: {
-        std::unordered_map<std::string_view, uint64_t> tag_map;
+        NameMap<uint64_t> tag_map;
         std::unordered_set<uint64_t> used_tags;
         uint64_t tag_counter = 0;
 
@@ -35,7 +35,7 @@
 // more likely to manifest as memory leaks rather than seg faults which is less
 // ideal.
 
-static std::unordered_map<TokenKind, HirOpKind> binop_table {
+static const std::unordered_map<TokenKind, HirOpKind> binop_table {
     { TOK_PLUS, HIROP_ADD },
     { TOK_MINUS, HIROP_SUB },
     { TOK_STAR, HIROP_MUL },
@@ -56,7 +56,7 @@ static std::unordered_map<TokenKind, HirOpKind> binop_table {
     { TOK_OR, HIROP_LGOR },
 };
 
-static std::unordered_map<TokenKind, HirOpKind> unop_table {
+static const std::unordered_map<TokenKind, HirOpKind> unop_table {
     { TOK_MINUS, HIROP_NEG },
     { TOK_TILDE, HIROP_BWNEG },
     { TOK_NOT, HIROP_NOT }
@@ -92,7 +92,7 @@ HirExpr* Checker::checkExpr(AstNode* node, Type* infer_type) {
     case AST_BINOP: {
         auto* hlhs = checkExpr(node->an_Binop.lhs);
         auto* hrhs = checkExpr(node->an_Binop.rhs);
-        auto hop = binop_table[node->an_Binop.op.tok_kind];
+        auto hop = binop_table.at(node->an_Binop.op.tok_kind);
 
         auto* result_type = mustApplyBinaryOp(
             node->span,
@@ -109,7 +109,7 @@ HirExpr* Checker::checkExpr(AstNode* node, Type* infer_type) {
     } break;
     case AST_UNOP: {
         auto* hoperand = checkExpr(node->an_Unop.expr);
-        auto hop = unop_table[node->an_Unop.op.tok_kind];
+        auto hop = unop_table.at(node->an_Unop.op.tok_kind);
 
         auto* result_type = mustApplyUnaryOp(node->span, hop, hoperand->type);
 
@@ -517,7 +517,7 @@ normal_func:
 }
 
 HirExpr* Checker::checkFactoryCall(const TextSpan& span, Type* type, std::span<AstNode*> args) {
-    auto* factory_func = type->ty_Named.factory;
+    auto* factory_func = findFactory(type);
     if (factory_func == nullptr) {
         fatal(span, "type {} has no factory function", type->ToString());
     }
@@ -526,7 +526,7 @@ HirExpr* Checker::checkFactoryCall(const TextSpan& span, Type* type, std::span<A
         if (factory_func->exported) {
             for (auto& dep : mod.deps) { // Add usage ID
                 if (dep.mod->id == factory_func->parent_id) {
-                    dep.usages.insert(factory_func->decl_num);
+                    addDepUsage(dep, factory_func->decl_num);
                     break;
                 }
             }
@@ -534,7 +534,7 @@ HirExpr* Checker::checkFactoryCall(const TextSpan& span, Type* type, std::span<A
             fatal(span, "factory function {}() is not exported", type->ToString());
         }
     } else if (!first_pass) {
-        init_graph[curr_decl_num].insert(factory_func->decl_num);
+        addInitEdge(factory_func->decl_num);
     }
 
     auto hargs = checkArgs(span, factory_func->signature, args);
@@ -553,15 +553,15 @@ std::span<HirExpr*> Checker::checkArgs(const TextSpan& span, Type* func_type, st
         fatal(span, "function expects {} arguments by got {}", fparams.size(), args.size());
     }
 
-    std::vector<HirExpr*> hargs;
+    ArenaList<HirExpr*> hargs(hir_arena, args.size());
     for (size_t i = 0; i < args.size(); i++) {
         auto* harg = checkExpr(args[i], fparams[i]);
         harg = subtypeCast(harg, fparams[i]);
 
-        hargs.push_back(harg);
+        hargs.Push(harg);
     }
 
-    return arena.MoveVec(std::move(hargs));
+    return hargs.Freeze();
 }
 
 HirExpr* Checker::checkSelector(AstNode* node, Type* infer_type) {
@@ -824,7 +824,7 @@ HirExpr* Checker::checkNewStruct(AstNode* node, Type* infer_type) {
 
     auto* hexpr = allocExpr(HIR_NEW_STRUCT, node->span);
     hexpr->type = ptr_type;
-    hexpr->ir_StructLit.field_inits = arena.MoveVec(std::move(field_inits));
+    hexpr->ir_StructLit.field_inits = hir_arena.MoveVec(std::move(field_inits));
     hexpr->ir_StructLit.alloc_mode = enclosing_return_type ? HIRMEM_STACK : HIRMEM_HEAP;
     return hexpr;
 }
@@ -841,13 +841,13 @@ HirExpr* Checker::checkArrayLit(AstNode* node, Type* infer_type) {
     }
 
     auto& aitems = node->an_ExprList.exprs;
-    std::vector<HirExpr*> items;
+    ArenaList<HirExpr*> items(hir_arena, aitems.size());
     for (auto* aitem : aitems) {
-        items.push_back(checkExpr(aitem, elem_infer_type));
+        items.Push(checkExpr(aitem, elem_infer_type));
     }
 
     auto* first_type = items[0]->type;
-    for (size_t i = 1; i < items.size(); i++) {
+    for (size_t i = 1; i < items.Len(); i++) {
         mustEqual(items[i]->span, first_type, items[i]->type);
     }
 
@@ -855,7 +855,7 @@ HirExpr* Checker::checkArrayLit(AstNode* node, Type* infer_type) {
     if (infer_type && infer_type->kind == TYPE_ARRAY) {
         arr_type = allocType(TYPE_ARRAY);
         arr_type->ty_Array.elem_type = first_type;
-        arr_type->ty_Array.len = (uint64_t)items.size();
+        arr_type->ty_Array.len = (uint64_t)items.Len();
     } else {
         arr_type = allocType(TYPE_SLICE);
         arr_type->ty_Slice.elem_type = first_type;
@@ -864,7 +864,7 @@ HirExpr* Checker::checkArrayLit(AstNode* node, Type* infer_type) {
 
     auto* hexpr = allocExpr(HIR_ARRAY_LIT, node->span);
     hexpr->type = arr_type;
-    hexpr->ir_ArrayLit.items = arena.MoveVec(std::move(items));
+    hexpr->ir_ArrayLit.items = items.Freeze();
     hexpr->ir_ArrayLit.alloc_mode = enclosing_return_type ? HIRMEM_STACK : HIRMEM_HEAP;
     return hexpr;
 }
@@ -892,7 +892,7 @@ HirExpr* Checker::checkStructLit(AstNode* node, Type* infer_type) {
 
     auto* hexpr = allocExpr(HIR_STRUCT_LIT, node->span);
     hexpr->type = type;
-    hexpr->ir_StructLit.field_inits = arena.MoveVec(std::move(field_inits));
+    hexpr->ir_StructLit.field_inits = hir_arena.MoveVec(std::move(field_inits));
     return hexpr;
 }
 
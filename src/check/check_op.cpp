@@ -1,6 +1,6 @@
 #include "checker.hpp"
 
-std::unordered_map<HirOpKind, std::string> hir_op_kind_to_name {
+static const std::unordered_map<HirOpKind, std::string> hir_op_kind_to_name {
     { HIROP_ADD, "+" },
     { HIROP_SUB, "-" },
     { HIROP_MUL, "*" },
@@ -120,7 +120,7 @@ Type* Checker::mustApplyBinaryOp(const TextSpan& span, HirOpKind op, Type* lhs_t
     if (return_type == nullptr) {
         Assert(hir_op_kind_to_name.contains(op), "missing op string for operator");
 
-        fatal(span, "cannot apply {} operator to {} and {}", hir_op_kind_to_name[op], lhs_outer_type->ToString(), rhs_outer_type->ToString());
+        fatal(span, "cannot apply {} operator to {} and {}", hir_op_kind_to_name.at(op), lhs_outer_type->ToString(), rhs_outer_type->ToString());
     }
 
     tctx.infer_enabled = false;
@@ -195,7 +195,7 @@ Type* Checker::mustApplyUnaryOp(const TextSpan& span, HirOpKind op, Type* operan
     if (return_type == nullptr) {
         Assert(hir_op_kind_to_name.find(op) != hir_op_kind_to_name.end(), "missing op string for operator");
 
-        fatal(span, "cannot apply {} operator to {}", hir_op_kind_to_name[op], operand_type->ToString());
+        fatal(span, "cannot apply {} operator to {}", hir_op_kind_to_name.at(op), operand_type->ToString());
     }
 
     tctx.infer_enabled = false;
@@ -2,21 +2,21 @@
 
 std::pair<std::span<HirExpr*>, bool> Checker::checkCasePattern(AstNode* node, Type* expect_type) {
     if (node->kind == AST_EXPR_LIST) {
-        std::vector<HirExpr*> hpatterns;
+        ArenaList<HirExpr*> hpatterns(hir_arena, node->an_ExprList.exprs.size());
         for (auto* apattern : node->an_ExprList.exprs) {
             auto [hpattern, captures] = checkPattern(apattern, expect_type);
             if (captures) {
                 fatal(node->span, "case with alternated patterns can't capture values");
             }
 
-            hpatterns.push_back(hpattern);
+            hpatterns.Push(hpattern);
         }
 
-        return { arena.MoveVec(std::move(hpatterns)), false };
+        return { hpatterns.Freeze(), false };
     }
 
     auto [hpattern, captures] = checkPattern(node, expect_type);
-    return { arena.MoveVec<HirExpr*>({ hpattern }), captures };
+    return { hir_arena.MoveVec<HirExpr*>({ hpattern }), captures };
 }
 
 std::pair<HirExpr*, bool> Checker::checkPattern(AstNode* node, Type* expect_type) {
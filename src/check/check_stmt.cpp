@@ -80,24 +80,24 @@ std::pair<HirStmt*, bool> Checker::checkStmt(AstNode* node) {
 std::pair<HirStmt*, bool> Checker::checkBlock(AstNode* node) {
     pushScope();
 
-    std::vector<HirStmt*> hstmts;
+    ArenaList<HirStmt*> hstmts(hir_arena, node->an_Block.stmts.size());
     bool always_returns = false;
     for (auto* astmt : node->an_Block.stmts) {
         auto [hstmt, stmt_always_returns] = checkStmt(astmt);
 
-        hstmts.push_back(hstmt);
+        hstmts.Push(hstmt);
         always_returns = stmt_always_returns || always_returns;
     }
 
     popScope();
 
     auto* hblock = allocStmt(HIR_BLOCK, node->span);
-    hblock->ir_Block.stmts = arena.MoveVec(std::move(hstmts));
+    hblock->ir_Block.stmts = hstmts.Freeze();
     return { hblock, always_returns };
 }
 
 std::pair<HirStmt*, bool> Checker::checkIf(AstNode* node) {
-    std::vector<HirIfBranch> hbranches;
+    ArenaList<HirIfBranch> hbranches(hir_arena, node->an_If.branches.size());
     bool always_returns = true;
 
     for (auto& abranch : node->an_If.branches) {
@@ -110,7 +110,7 @@ std::pair<HirStmt*, bool> Checker::checkIf(AstNode* node) {
         auto [hbody, body_always_returns] = checkStmt(abranch.body);
         always_returns = body_always_returns && always_returns;
 
-        hbranches.emplace_back(hcond, hbody);
+        hbranches.Emplace(hcond, hbody);
 
         popScope();
     }
@@ -126,7 +126,7 @@ std::pair<HirStmt*, bool> Checker::checkIf(AstNode* node) {
     }
 
     auto* hif = allocStmt(HIR_IF, node->span);
-    hif->ir_If.branches = arena.MoveVec(std::move(hbranches));
+    hif->ir_If.branches = hbranches.Freeze();
     hif->ir_If.else_stmt = helse_stmt;
 
     return { hif, always_returns };
@@ -286,7 +286,7 @@ std::pair<HirStmt*, bool> Checker::checkMatchStmt(AstNode* node) {
 
     auto* hmatch = allocStmt(HIR_MATCH, node->span);
     hmatch->ir_Match.expr = hcond;
-    hmatch->ir_Match.cases = arena.MoveVec(std::move(hcases));
+    hmatch->ir_Match.cases = hir_arena.MoveVec(std::move(hcases));
     hmatch->ir_Match.is_implicit_exhaustive = false;
 
     if (hit_always_match) {
@@ -375,7 +375,7 @@ HirStmt* Checker::checkLocalConst(AstNode* node) {
     return hconst;
 }
 
-static std::unordered_map<TokenKind, HirOpKind> assign_ops {
+static const std::unordered_map<TokenKind, HirOpKind> assign_ops {
     { TOK_PLUS_ASSIGN, HIROP_ADD },
     { TOK_MINUS_ASSIGN, HIROP_SUB },
     { TOK_STAR_ASSIGN, HIROP_MUL },
@@ -410,7 +410,7 @@ HirStmt* Checker::checkAssign(AstNode* node) {
     }
 
     auto* hrhs = checkExpr(aassign.rhs);
-    auto op = assign_ops[aassign.op.tok_kind];
+    auto op = assign_ops.at(aassign.op.tok_kind);
     auto* result_type = mustApplyBinaryOp(node->span, op, hlhs->type, hrhs->type);
     bool needs_subtype_cast = mustSubType(node->span, result_type, hlhs->type);
     finishExpr();
@@ -1,7 +1,10 @@
 #include "checker.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
 
 Checker::Checker(Arena& arena, Module& mod)
 : arena(arena)
+, hir_arena(mod.hir_arena)
 , mod(mod)
 , sorted_decls(mod.decls.size())
 , init_graph(mod.decls.size())
@@ -16,6 +19,20 @@ Checker::Checker(Arena& arena, Module& mod)
     }
 }
 
+Checker::Checker(Arena& arena, Checker& parent)
+: arena(arena)
+, hir_arena(parent.hir_arena)
+, mod(parent.mod)
+, core_dep(parent.core_dep)
+, first_pass(false)
+, parent(&parent)
+{}
+
+void Checker::EnableParallelBodies(size_t n_workers) {
+    Assert(arena.IsConcurrent() && hir_arena.IsConcurrent(), "parallel body checking requires concurrent arenas");
+    n_body_workers = n_workers;
+}
+
 void Checker::CheckModule() {
     // First checking pass.
     curr_decl_num = 0;
@@ -24,42 +41,21 @@ void Checker::CheckModule() {
         curr_decl_num++;
     }
 
-    // Second checking pass.
-    first_pass = false;
-    curr_decl_num = 0;
+    // Reset colors for init ordering.
     for (auto* decl : mod.decls) {
-        src_file = &mod.files[decl->file_num];
-
-        // Reset colors for init ordering.
         decl->color = COLOR_WHITE;
+    }
 
-        // Handle unsafe decls.
-        unsafe_depth = (int)((decl->flags & DECL_UNSAFE) > 0);
-
-        switch (decl->hir_decl->kind) {
-        case HIR_FUNC:
-            if (decl->ast_decl->an_Func.body) {
-                decl->hir_decl->ir_Func.body = checkFuncBody(
-                    decl->ast_decl->an_Func.body,
-                    decl->hir_decl->ir_Func.params,
-                    decl->hir_decl->ir_Func.return_type
-                );
-            }
-            break;
-        case HIR_METHOD:
-            checkMethodBody(decl);
-            break;
-        case HIR_FACTORY:
-            decl->hir_decl->ir_Factory.body = checkFuncBody(
-                decl->ast_decl->an_Factory.body,
-                decl->hir_decl->ir_Factory.params,
-                decl->hir_decl->ir_Factory.return_type
-            );
-            break;
+    // Second checking pass.
+    first_pass = false;
+    if (n_body_workers > 1) {
+        checkBodiesParallel();
+    } else {
+        curr_decl_num = 0;
+        for (auto* decl : mod.decls) {
+            checkDeclBody(decl);
+            curr_decl_num++;
         }
-
-        unsafe_depth = 0;
-        curr_decl_num++;
     }
 
     // Sort remaining declarations into correct initialization order.
@@ -104,7 +100,7 @@ void Checker::CheckModule() {
             decl->hir_decl->ir_Method.method->decl_num = curr_decl_num;
             break;
         case HIR_FACTORY:
-            decl->hir_decl->ir_Factory.bind_type->ty_Named.factory->decl_num = curr_decl_num;
+            decl->hir_decl->ir_Factory.func->decl_num = curr_decl_num;
             break;
         }
 
@@ -112,6 +108,122 @@ void Checker::CheckModule() {
     }
 }
 
+// getDeclTraceName returns the name of decl to display in the time trace.
+static std::string_view getDeclTraceName(Decl* decl) {
+    switch (decl->hir_decl->kind) {
+    case HIR_FUNC:
+        return decl->hir_decl->ir_Func.symbol->name;
+    case HIR_METHOD:
+        return decl->hir_decl->ir_Method.method->name;
+    case HIR_FACTORY:
+        return "<factory>";
+    default:
+        return "";
+    }
+}
+
+void Checker::checkDeclBody(Decl* decl) {
+    // Only the declarations which are slow to check are traced.
+    TraceScope trace_scope("Check Decl", getDeclTraceName(decl), TRACE_GRANULARITY_US);
+
+    src_file = &mod.files[decl->file_num];
+
+    // Handle unsafe decls.
+    unsafe_depth = (int)((decl->flags & DECL_UNSAFE) > 0);
+
+    switch (decl->hir_decl->kind) {
+    case HIR_FUNC:
+        if (decl->ast_decl->an_Func.body) {
+            decl->hir_decl->ir_Func.body = checkFuncBody(
+                decl->ast_decl->an_Func.body,
+                decl->hir_decl->ir_Func.params,
+                decl->hir_decl->ir_Func.return_type
+            );
+        }
+        break;
+    case HIR_METHOD:
+        checkMethodBody(decl);
+        break;
+    case HIR_FACTORY:
+        decl->hir_decl->ir_Factory.body = checkFuncBody(
+            decl->ast_decl->an_Factory.body,
+            decl->hir_decl->ir_Factory.params,
+            decl->hir_decl->ir_Factory.return_type
+        );
+        break;
+    }
+
+    unsafe_depth = 0;
+}
+
+void Checker::checkBodiesParallel() {
+    // Only the bodies of functions, methods, and factories are checked in the
+    // second pass: the other declarations don't need a task.
+    std::vector<size_t> body_decl_nums;
+    for (size_t i = 0; i < mod.decls.size(); i++) {
+        switch (mod.decls[i]->hir_decl->kind) {
+        case HIR_FUNC: case HIR_METHOD: case HIR_FACTORY:
+            body_decl_nums.push_back(i);
+            break;
+        }
+    }
+
+    std::vector<std::unique_ptr<Checker>> tasks(body_decl_nums.size());
+    std::vector<DiagnosticBuffer> diag_buffs(body_decl_nums.size());
+    std::vector<char> failed(body_decl_nums.size(), false);
+
+    // Every body is checked to completion even if one of them fails so that
+    // the errors reported don't depend on timing.
+    ParallelFor(n_body_workers, body_decl_nums.size(), [&](size_t, size_t i) {
+        CaptureDiagnostics capture(diag_buffs[i]);
+
+        tasks[i] = std::unique_ptr<Checker>(new Checker(arena, *this));
+        tasks[i]->curr_decl_num = body_decl_nums[i];
+        try {
+            tasks[i]->checkDeclBody(mod.decls[body_decl_nums[i]]);
+        } catch (CompileError&) {
+            failed[i] = true;
+        }
+    });
+
+    // Diagnostics are displayed and the tasks' results are merged in
+    // declaration order so that the output is the same as sequential checking.
+    bool any_failed = false;
+    for (size_t i = 0; i < tasks.size(); i++) {
+        diag_buffs[i].Flush();
+        any_failed = any_failed || failed[i];
+
+        auto& edges = init_graph[body_decl_nums[i]];
+        for (size_t edge : tasks[i]->body_init_edges) {
+            edges.insert(edge);
+        }
+
+        for (auto& [dep, decl_num] : tasks[i]->body_usages) {
+            dep->usages.insert(decl_num);
+        }
+    }
+
+    if (any_failed) {
+        throw CompileError{};
+    }
+}
+
+void Checker::addInitEdge(size_t decl_num) {
+    if (parent != nullptr) {
+        body_init_edges.push_back(decl_num);
+    } else {
+        init_graph[curr_decl_num].insert(decl_num);
+    }
+}
+
+void Checker::addDepUsage(Module::DepEntry& dep, size_t decl_num) {
+    if (parent != nullptr) {
+        body_usages.push_back({ &dep, decl_num });
+    } else {
+        dep.usages.insert(decl_num);
+    }
+}
+
 /* -------------------------------------------------------------------------- */
 
 static Symbol* getDeclSymbol(Decl* decl) {
@@ -314,12 +426,10 @@ HirExpr* Checker::subtypeCast(HirExpr* src, Type* dest_type) {
 /* -------------------------------------------------------------------------- */
 
 std::pair<Symbol*, Module::DepEntry*> Checker::mustLookup(std::string_view name, const TextSpan& span) {
-    for (int i = scope_stack.size() - 1; i >= 0; i--) {
-        auto& scope = scope_stack[i];
-
-        auto it = scope.find(name);
-        if (it != scope.end()) {
-            return { it->second, nullptr };
+    if (locals.size() > 0) {
+        auto local_it = local_heads.find(name);
+        if (local_it != local_heads.end() && local_it->second != LOCAL_NONE) {
+            return { locals[local_it->second].symbol, nullptr };
         }
     }
 
@@ -331,7 +441,7 @@ std::pair<Symbol*, Module::DepEntry*> Checker::mustLookup(std::string_view name,
     auto it = mod.symbol_table.find(name);
     if (it != mod.symbol_table.end()) {
         if ((it->second->flags & SYM_COMPTIME) == 0) {
-            init_graph[curr_decl_num].insert(it->second->decl_num);
+            addInitEdge(it->second->decl_num);
         }
 
         return { it->second, nullptr };
@@ -356,7 +466,7 @@ Symbol* Checker::findSymbolInDep(Module::DepEntry& dep, std::string_view name) {
 
     auto* imported_symbol = it->second;
     if (imported_symbol->flags & SYM_EXPORTED) {
-        dep.usages.insert(imported_symbol->decl_num);
+        addDepUsage(dep, imported_symbol->decl_num);
         return imported_symbol;
     }
 
@@ -376,29 +486,25 @@ Symbol* Checker::mustFindSymbolInDep(Module::DepEntry& dep, std::string_view nam
 
 Method* Checker::tryLookupMethod(const TextSpan& span, Type* bind_type, std::string_view method_name) {
     if (bind_type->kind == TYPE_NAMED || bind_type->kind == TYPE_ALIAS) {
-        if (bind_type->ty_Named.methods != nullptr) {
-            auto it = bind_type->ty_Named.methods->find(method_name);
-            if (it != bind_type->ty_Named.methods->end()) {
-                auto* method = it->second;
-
-                if (method->parent_id != mod.id) {
-                    if (method->exported) {
-                        // Add the appropriate usage entry.
-                        for (auto& dep : mod.deps) {
-                            if (dep.mod->id == method->parent_id) {
-                                dep.usages.insert(method->decl_num);
-                                break;
-                            }
+        auto* method = findMethod(bind_type, method_name);
+        if (method != nullptr) {
+            if (method->parent_id != mod.id) {
+                if (method->exported) {
+                    // Add the appropriate usage entry.
+                    for (auto& dep : mod.deps) {
+                        if (dep.mod->id == method->parent_id) {
+                            addDepUsage(dep, method->decl_num);
+                            break;
                         }
-                    } else {
-                        fatal(span, "method {} of type {} is not exported", method_name, bind_type->ToString());
                     }
-                } else if (!first_pass) { // Do we even need this check?
-                    init_graph[curr_decl_num].insert(method->decl_num);
+                } else {
+                    fatal(span, "method {} of type {} is not exported", method_name, bind_type->ToString());
                 }
-
-                return method;
+            } else if (!first_pass) { // Do we even need this check?
+                addInitEdge(method->decl_num);
             }
+
+            return method;
         }
     }
 
@@ -408,23 +514,32 @@ Method* Checker::tryLookupMethod(const TextSpan& span, Type* bind_type, std::str
 /* -------------------------------------------------------------------------- */
 
 void Checker::declareLocal(Symbol* sym) {
-    Assert(scope_stack.size() > 0, "declare local on empty scope stack");
+    Assert(scope_starts.size() > 0, "declare local on empty scope stack");
 
-    auto& curr_scope = scope_stack.back();
-
-    if (!curr_scope.contains(sym->name)) {
-        curr_scope[sym->name] = sym;
-    } else {
+    // Only the innermost declaration of the name can be in the current scope.
+    auto& head = local_heads.try_emplace(sym->name, LOCAL_NONE).first->second;
+    if (head != LOCAL_NONE && locals[head].depth == scope_starts.size()) {
         fatal(sym->span, "multiple definitions of local variable {} in the same scope", sym->name);
     }
+
+    locals.push_back({ sym, scope_starts.size(), head });
+    head = locals.size() - 1;
 }
 
 void Checker::pushScope() {
-    scope_stack.push_back({});
+    scope_starts.push_back(locals.size());
 }
 
 void Checker::popScope() {
-    Assert(scope_stack.size() > 0, "pop on empty scope stack");
+    Assert(scope_starts.size() > 0, "pop on empty scope stack");
+
+    // The names' entries in local_heads are kept once they are no longer
+    // declared so that they can be reused by later scopes.
+    while (locals.size() > scope_starts.back()) {
+        auto& entry = locals.back();
+        local_heads.find(entry.symbol->name)->second = entry.prev;
+        locals.pop_back();
+    }
 
-    scope_stack.pop_back();
+    scope_starts.pop_back();
 }
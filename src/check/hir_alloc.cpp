@@ -1,4 +1,5 @@
 #include "checker.hpp"
+#include "stats.hpp"
 
 HirDecl size_ref_decl;
 HirStmt size_ref_stmt;
@@ -78,6 +79,8 @@ HirDecl* Checker::allocDecl(HirKind kind, const TextSpan& span) {
     size_t variant_size = hir_variant_sizes[(size_t)kind];
     size_t alloc_size = sizeof(size_ref_decl) - LARGEST_DECL_VARIANT_SIZE + variant_size;
 
+    CountHirNode(kind);
+
     auto* hdecl = (HirDecl*)arena.Alloc(alloc_size);
     hdecl->kind = kind;
     hdecl->span = span;
@@ -91,7 +94,9 @@ HirStmt* Checker::allocStmt(HirKind kind, const TextSpan& span) {
     size_t variant_size = hir_variant_sizes[(size_t)kind];
     size_t alloc_size = sizeof(size_ref_stmt) - LARGEST_STMT_VARIANT_SIZE + variant_size;
 
-    auto* hstmt = (HirStmt*)arena.Alloc(alloc_size);
+    CountHirNode(kind);
+
+    auto* hstmt = (HirStmt*)hir_arena.Alloc(alloc_size);
     hstmt->kind = kind;
     hstmt->span = span;
 
@@ -104,7 +109,9 @@ HirExpr* Checker::allocExpr(HirKind kind, const TextSpan& span) {
     size_t variant_size = hir_variant_sizes[(size_t)kind];
     size_t alloc_size = sizeof(size_ref_expr) - LARGEST_EXPR_VARIANT_SIZE + variant_size;
 
-    auto* hexpr = (HirExpr*)arena.Alloc(alloc_size);
+    CountHirNode(kind);
+
+    auto* hexpr = (HirExpr*)hir_arena.Alloc(alloc_size);
     hexpr->kind = kind;
     hexpr->span = span;
     hexpr->type = nullptr;
@@ -55,7 +55,7 @@ void CodeGenerator::genBuiltinFuncs() {
     ll_init_func = llvm::Function::Create(
         ll_rtstub_void_type, 
         llvm::Function::ExternalLinkage, 
-        std::format("__berry_initmod${}", src_mod.id), 
+        GetInitFuncName(src_mod), 
         mod
     );
     ll_init_block = llvm::BasicBlock::Create(ctx, "entry", ll_init_func);
@@ -121,7 +121,7 @@ void CodeGenerator::finishModule() {
         ) {
             irb.CreateCall(
                 llvm::FunctionType::get(llvm::Type::getVoidTy(ctx), false), 
-                sym->llvm_value
+                symbol_values.at(sym)
             );
         }
     }
@@ -142,9 +142,6 @@ void CodeGenerator::finishModule() {
         mod.print(llvm::errs(), nullptr);
         exit(1);
     }
-
-    // Add the init function call to rt_main.
-    mainb.GenInitCall(ll_init_func);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -246,20 +243,24 @@ llvm::Type* CodeGenerator::genNamedBaseType(Type* type, bool alloc_type, std::st
     switch (type->kind) {
     case TYPE_STRUCT:
         if (alloc_type || !shouldPtrWrap(type)) {
-            if (type->ty_Struct.llvm_type == nullptr) {
-                std::vector<llvm::Type*> field_types(type->ty_Struct.fields.size());
-                for (size_t i = 0; i < field_types.size(); i++) {
-                    field_types[i] = genType(type->ty_Struct.fields[i].type, true);
-                }
-
-                if (type_name.size() == 0) {
-                    type->ty_Struct.llvm_type = llvm::StructType::get(ctx, field_types);
-                } else {
-                    type->ty_Struct.llvm_type = llvm::StructType::create(ctx, field_types, mangleName(type_name));
-                }
-            } 
-            
-            return type->ty_Struct.llvm_type;
+            if (auto it = struct_types.find(type); it != struct_types.end()) {
+                return it->second;
+            }
+
+            std::vector<llvm::Type*> field_types(type->ty_Struct.fields.size());
+            for (size_t i = 0; i < field_types.size(); i++) {
+                field_types[i] = genType(type->ty_Struct.fields[i].type, true);
+            }
+
+            llvm::Type* ll_struct_type;
+            if (type_name.size() == 0) {
+                ll_struct_type = llvm::StructType::get(ctx, field_types);
+            } else {
+                ll_struct_type = llvm::StructType::create(ctx, field_types, mangleName(type_name));
+            }
+
+            struct_types[type] = ll_struct_type;
+            return ll_struct_type;
         }
 
         return llvm::PointerType::get(ctx, 0);
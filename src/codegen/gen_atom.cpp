@@ -1,4 +1,5 @@
 #include "codegen.hpp"
+#include "stats.hpp"
 
 llvm::Value* CodeGenerator::genCall(HirExpr* node, llvm::Value* alloc_loc) {
     auto* func_ptr = genExpr(node->ir_Call.func);
@@ -48,7 +49,7 @@ llvm::Value* CodeGenerator::genCallMethod(HirExpr* node, llvm::Value* alloc_loc)
     
     llvm::Value* ll_method = nullptr;
     if (hmcall.method->parent_id == src_mod.id) {
-        ll_method = hmcall.method->llvm_value;
+        ll_method = method_values.at(hmcall.method);
     } else {
         for (auto& dep : src_mod.deps) {
             if (dep.mod->id == hmcall.method->parent_id) {
@@ -87,7 +88,7 @@ llvm::Value* CodeGenerator::genCallFactory(HirExpr* node, llvm::Value* alloc_loc
 
     llvm::Value* ll_factory = nullptr;
     if (hfcall.func->parent_id == src_mod.id) {
-        ll_factory = hfcall.func->llvm_value;
+        ll_factory = factory_values.at(hfcall.func);
     } else {
         for (auto& dep : src_mod.deps) {
             if (dep.mod->id == hfcall.func->parent_id) {
@@ -548,7 +549,7 @@ llvm::Value* CodeGenerator::genIdent(HirExpr* node, bool expect_addr) {
         
         ll_value = loaded_imports.back()[symbol->decl_num];
     } else {
-        ll_value = symbol->llvm_value;
+        ll_value = symbol_values.at(symbol);
     }
     
     if ((symbol->flags & SYM_VAR) && !expect_addr && !shouldPtrWrap(node->type)) {
@@ -621,6 +622,7 @@ void CodeGenerator::genBoundsCheck(llvm::Value* ndx, llvm::Value* arr_len, bool
         is_lt_len = irb.CreateICmpSLT(ndx, arr_len);
     }
     auto* is_in_bounds = irb.CreateAnd(is_ge_zero, is_lt_len);
+    CountStat(STAT_BOUNDS_CHECKS);
     is_in_bounds = genLLVMExpect(is_in_bounds, makeLLVMIntLit(&prim_bool_type, 1));
 
     auto* bb_oob = appendBlock();
@@ -26,7 +26,7 @@ llvm::Constant* CodeGenerator::genComptime(ConstValue* value, ComptimeGenFlags f
         auto* sym = value->v_func;
 
         if (sym->parent_id == src_mod.id) {
-            return llvm::dyn_cast<llvm::Constant>(sym->llvm_value);
+            return llvm::dyn_cast<llvm::Constant>(symbol_values.at(sym));
         } else {
             size_t dep_id = 0;
             for (auto& dep : src_mod.deps) {
@@ -55,8 +55,6 @@ llvm::Constant* CodeGenerator::genComptime(ConstValue* value, ComptimeGenFlags f
     }
 }
 
-static size_t const_id_counter = 0;
-
 llvm::Constant* CodeGenerator::genComptimeArray(ConstValue* value, ComptimeGenFlags flags, Type* expect_type) {
     auto* ll_arr_data_type = llvm::ArrayType::get(
         genType(value->v_array.elem_type, true), 
@@ -66,8 +64,9 @@ llvm::Constant* CodeGenerator::genComptimeArray(ConstValue* value, ComptimeGenFl
     bool expect_array = expect_type->Inner()->kind == TYPE_ARRAY;
     bool expect_unwrapped_array = expect_array && (flags & CTG_UNWRAPPED);
 
+    auto it = const_globals.find(value);
     llvm::Constant* gv;
-    if (value->v_array.alloc_loc == nullptr || expect_unwrapped_array) {
+    if (it == const_globals.end() || expect_unwrapped_array) {
         std::vector<llvm::Constant*> ll_elems;
         for (auto* elem : value->v_array.elems) {
             ll_elems.push_back(genComptime(elem, flags | CTG_UNWRAPPED, value->v_array.elem_type));
@@ -78,30 +77,11 @@ llvm::Constant* CodeGenerator::genComptimeArray(ConstValue* value, ComptimeGenFl
             return ll_array;
         }
 
-        gv = new llvm::GlobalVariable(
-            mod, 
-            ll_arr_data_type, 
-            (bool)(flags & CTG_CONST), 
-            (flags & CTG_EXPORTED) ? llvm::GlobalValue::ExternalLinkage : llvm::GlobalValue::PrivateLinkage, 
-            ll_array, 
-            std::format("__$const{}", const_id_counter++)
-        );
-    } else if (value->v_array.mod_id == src_mod.id) {
-        gv = value->v_array.alloc_loc;
+        gv = genConstGlobal(value, ll_array, flags);
     } else {
-        gv = new llvm::GlobalVariable(
-            mod, 
-            ll_arr_data_type, 
-            llvm::dyn_cast<llvm::GlobalVariable>(value->v_array.alloc_loc)->isConstant(), 
-            llvm::GlobalValue::ExternalLinkage, 
-            nullptr, 
-            value->v_array.alloc_loc->getName()
-        );
+        gv = it->second;
     }
 
-    value->v_array.alloc_loc = gv;
-    value->v_array.mod_id = src_mod.id;
-
     if (expect_array) {
         return gv;
     }
@@ -120,31 +100,12 @@ llvm::Constant* CodeGenerator::genComptimeZeroArray(ConstValue* value, ComptimeG
     llvm::Constant* gv;
     if (expect_array && (flags & CTG_UNWRAPPED)) {
         return getNullValue(ll_arr_data_type);
-    } else if (value->v_zarr.alloc_loc == nullptr) {
-        gv = new llvm::GlobalVariable(
-            mod, 
-            ll_arr_data_type, 
-            (bool)(flags & CTG_CONST), 
-            (flags & CTG_EXPORTED) ? llvm::GlobalValue::ExternalLinkage : llvm::GlobalValue::PrivateLinkage,  
-            getNullValue(ll_arr_data_type), 
-            std::format("__$const{}", const_id_counter++)
-        );
-    } else if (value->v_zarr.mod_id == src_mod.id) {
-        gv = value->v_zarr.alloc_loc;
+    } else if (auto it = const_globals.find(value); it != const_globals.end()) {
+        gv = it->second;
     } else {
-        gv = new llvm::GlobalVariable(
-            mod, 
-            ll_arr_data_type, 
-            llvm::dyn_cast<llvm::GlobalVariable>(value->v_zarr.alloc_loc)->isConstant(), 
-            llvm::GlobalValue::ExternalLinkage, 
-            nullptr, 
-            value->v_zarr.alloc_loc->getName()
-        );
+        gv = genConstGlobal(value, getNullValue(ll_arr_data_type), flags);
     }
 
-    value->v_zarr.alloc_loc = gv;
-    value->v_zarr.mod_id = src_mod.id;
-
     if (expect_array) {
         return gv;
     }
@@ -153,39 +114,15 @@ llvm::Constant* CodeGenerator::genComptimeZeroArray(ConstValue* value, ComptimeG
 }
 
 llvm::Constant* CodeGenerator::genComptimeString(ConstValue* value, ComptimeGenFlags flags) {
-    auto* ll_string_type = llvm::ArrayType::get(
-        llvm::Type::getInt8Ty(ctx),
-        value->v_str.value.size()
-    );
-
     llvm::Constant* gv;
-    
-    if (value->v_str.alloc_loc == nullptr) {
+    if (auto it = const_globals.find(value); it != const_globals.end()) {
+        gv = it->second;
+    } else {
         auto decoded = decodeStrLit(value->v_str.value);
         auto str_const = llvm::ConstantDataArray::getString(ctx, decoded, false);
-        gv = new llvm::GlobalVariable(
-            mod,
-            str_const->getType(),
-            (bool)(flags & CTG_CONST), 
-            (flags & CTG_EXPORTED) ? llvm::GlobalValue::ExternalLinkage : llvm::GlobalValue::PrivateLinkage,
-            str_const,
-            std::format("__$const{}", const_id_counter++)
-        );
-    } else if (value->v_str.mod_id == src_mod.id) {
-        gv = value->v_str.alloc_loc;
-    } else {
-        gv = new llvm::GlobalVariable(
-            mod,
-            value->v_str.alloc_loc->getType(),
-            llvm::dyn_cast<llvm::GlobalVariable>(value->v_str.alloc_loc)->isConstant(), 
-            llvm::GlobalValue::ExternalLinkage, 
-            nullptr, 
-            value->v_str.alloc_loc->getName()
-        );
+        gv = genConstGlobal(value, str_const, flags);
     }
 
-    value->v_str.alloc_loc = gv;
-    value->v_str.mod_id = src_mod.id;
     return llvm::ConstantStruct::get(ll_slice_type, { gv, getPlatformIntConst(value->v_str.value.size()) });
 }
 
@@ -197,33 +134,12 @@ llvm::Constant* CodeGenerator::genComptimeStruct(ConstValue* value, ComptimeGenF
         return genComptimeInnerStruct(value, flags, struct_type);
     }
 
-    llvm::Constant* gv;
-    if (value->v_struct.alloc_loc == nullptr) {
-        auto* struct_const = genComptimeInnerStruct(value, flags, struct_type);
-        gv = new llvm::GlobalVariable(
-            mod,
-            struct_const->getType(),
-            (bool)(flags & CTG_CONST), 
-            (flags & CTG_EXPORTED) ? llvm::GlobalValue::ExternalLinkage : llvm::GlobalValue::PrivateLinkage,
-            struct_const,
-            std::format("__$const{}", const_id_counter++)
-        );
-    } else if (value->v_struct.mod_id == src_mod.id) {
-        gv = value->v_struct.alloc_loc;
-    } else {
-        gv = new llvm::GlobalVariable(
-            mod,
-            genType(struct_type, true),
-            llvm::dyn_cast<llvm::GlobalVariable>(value->v_struct.alloc_loc)->isConstant(),
-            llvm::GlobalValue::ExternalLinkage,
-            nullptr,
-            value->v_struct.alloc_loc->getName()
-        );
-    }
+    if (auto it = const_globals.find(value); it != const_globals.end()) {
+        return it->second;
+    } 
 
-    value->v_struct.alloc_loc = gv;
-    value->v_struct.mod_id = src_mod.id;
-    return gv;
+    auto* struct_const = genComptimeInnerStruct(value, flags, struct_type);
+    return genConstGlobal(value, struct_const, flags);
 }
 
 llvm::Constant* CodeGenerator::genComptimeInnerStruct(ConstValue* value, ComptimeGenFlags flags, Type* expect_type) {
@@ -241,3 +157,23 @@ llvm::Constant* CodeGenerator::genComptimeInnerStruct(ConstValue* value, Comptim
         field_values
     );
 }
+
+/* -------------------------------------------------------------------------- */
+
+llvm::Constant* CodeGenerator::genConstGlobal(ConstValue* value, llvm::Constant* init, ComptimeGenFlags flags) {
+    // Constant data is always private to the module generating it: modules
+    // which import a constant materialize their own copy rather than linking
+    // against the defining module's global.  This keeps code generation for
+    // each module independent of the order in which modules are generated.
+    auto* gv = new llvm::GlobalVariable(
+        mod,
+        init->getType(),
+        (bool)(flags & CTG_CONST),
+        llvm::GlobalValue::PrivateLinkage,
+        init,
+        std::format("__$const{}", const_id_counter++)
+    );
+
+    const_globals[value] = gv;
+    return gv;
+}
@@ -80,29 +80,23 @@ void CodeGenerator::genFuncProto(Decl* decl) {
 
     auto* ll_func_type = genFuncType(symbol->type);
 
-    std::string ll_name {};
     bool exported = symbol->flags & SYM_EXPORTED;
     llvm::CallingConv::ID cconv = llvm::CallingConv::C;
     bool inline_hint = false;
     for (auto& attr : decl->attrs) {
         if (attr.name == "extern" || attr.name == "abientry") {
             exported = true;
-            ll_name = attr.value.size() == 0 ? symbol->name : attr.value;
         } else if (attr.name == "callconv") {
-            cconv = cconv_name_to_id[attr.value];
+            cconv = cconv_name_to_id.at(attr.value);
         } else if (attr.name == "inline") {
             inline_hint = true;
         }
     }
 
-    if (ll_name.size() == 0) {
-        ll_name = mangleName(symbol->name);
-    }
-
     auto* ll_func = llvm::Function::Create(
         ll_func_type, 
         exported ? llvm::Function::ExternalLinkage : llvm::Function::PrivateLinkage,
-        ll_name,
+        GetFuncLLName(src_mod, decl),
         mod
     );
 
@@ -117,10 +111,10 @@ void CodeGenerator::genFuncProto(Decl* decl) {
         auto arg = ll_func->getArg(i + offset);
 
         arg->setName(node->ir_Func.params[i]->name);
-        node->ir_Func.params[i]->llvm_value = arg;
+        symbol_values[node->ir_Func.params[i]] = arg;
     }
 
-    symbol->llvm_value = ll_func;
+    symbol_values[symbol] = ll_func;
 }
 
 void CodeGenerator::genMethodProto(Decl* decl) {
@@ -156,14 +150,14 @@ void CodeGenerator::genMethodProto(Decl* decl) {
         auto arg = ll_func->getArg(i + offset);
 
         arg->setName(node->ir_Method.params[i]->name);
-        node->ir_Method.params[i]->llvm_value = arg;
+        symbol_values[node->ir_Method.params[i]] = arg;
     }
 
     auto arg = ll_func->getArg(offset - 1);
     arg->setName("self");
-    node->ir_Method.self_ptr->llvm_value = arg;
+    symbol_values[node->ir_Method.self_ptr] = arg;
 
-    method->llvm_value = ll_func;
+    method_values[method] = ll_func;
 }
 
 void CodeGenerator::genFactoryProto(Decl* decl) {
@@ -199,10 +193,10 @@ void CodeGenerator::genFactoryProto(Decl* decl) {
         auto arg = ll_func->getArg(i + offset);
 
         arg->setName(node->ir_Factory.params[i]->name);
-        node->ir_Factory.params[i]->llvm_value = arg;
+        symbol_values[node->ir_Factory.params[i]] = arg;
     }
 
-    factory->llvm_value = ll_func;
+    factory_values[factory] = ll_func;
 }
 
 llvm::FunctionType* CodeGenerator::genFuncType(Type* type, bool has_self_ptr) {
@@ -238,10 +232,10 @@ void CodeGenerator::genFuncBody(Decl* decl) {
         return;
     }
 
-    debug.BeginFuncBody(decl, llvm::dyn_cast<llvm::Function>(node->ir_Func.symbol->llvm_value));
+    debug.BeginFuncBody(decl, llvm::dyn_cast<llvm::Function>(symbol_values.at(node->ir_Func.symbol)));
     debug.ClearDebugLocation();
 
-    auto* ll_func = llvm::dyn_cast<llvm::Function>(node->ir_Func.symbol->llvm_value);
+    auto* ll_func = llvm::dyn_cast<llvm::Function>(symbol_values.at(node->ir_Func.symbol));
     var_block = llvm::BasicBlock::Create(ctx, "entry", ll_func);
 
     genInnerFuncBody(node->ir_Func.return_type, ll_func, node->ir_Func.params, node->ir_Func.body);
@@ -255,13 +249,13 @@ void CodeGenerator::genMethodBody(Decl* decl) {
     // TODO: method debug info
     debug.ClearDebugLocation();
 
-    auto* ll_func = llvm::dyn_cast<llvm::Function>(node->ir_Method.method->llvm_value);
+    auto* ll_func = llvm::dyn_cast<llvm::Function>(method_values.at(node->ir_Method.method));
     var_block = llvm::BasicBlock::Create(ctx, "entry", ll_func);
     setCurrentBlock(var_block);
 
     auto* ll_self_ptr = irb.CreateAlloca(llvm::PointerType::get(ctx, 0));
-    irb.CreateStore(node->ir_Method.self_ptr->llvm_value, ll_self_ptr);
-    node->ir_Method.self_ptr->llvm_value = ll_self_ptr;
+    irb.CreateStore(symbol_values.at(node->ir_Method.self_ptr), ll_self_ptr);
+    symbol_values[node->ir_Method.self_ptr] = ll_self_ptr;
     
     genInnerFuncBody(node->ir_Method.return_type, ll_func, node->ir_Method.params, node->ir_Method.body);
 
@@ -274,7 +268,7 @@ void CodeGenerator::genFactoryBody(Decl* decl) {
     // TODO: factory debug info
     debug.ClearDebugLocation();
 
-    auto* ll_func = llvm::dyn_cast<llvm::Function>(node->ir_Factory.func->llvm_value);
+    auto* ll_func = llvm::dyn_cast<llvm::Function>(factory_values.at(node->ir_Factory.func));
     var_block = llvm::BasicBlock::Create(ctx, "entry", ll_func);
     
     genInnerFuncBody(node->ir_Factory.return_type, ll_func, node->ir_Factory.params, node->ir_Factory.body);
@@ -290,12 +284,12 @@ void CodeGenerator::genInnerFuncBody(Type* return_type, llvm::Function* ll_func,
         auto* ll_param = irb.CreateAlloca(ll_type);
 
         if (shouldPtrWrap(ll_type)) {
-            genMemCopy(ll_type, param->llvm_value, ll_param);
+            genMemCopy(ll_type, symbol_values.at(param), ll_param);
         } else {
-            irb.CreateStore(param->llvm_value, ll_param);
+            irb.CreateStore(symbol_values.at(param), ll_param);
         }
         
-        param->llvm_value = ll_param;
+        symbol_values[param] = ll_param;
     }
 
     if (shouldPtrWrap(return_type)) {
@@ -349,8 +343,7 @@ void CodeGenerator::genGlobalVarDecl(Decl* decl) {
     if (aglobal.const_init == nullptr) {
         init_value = llvm::Constant::getNullValue(ll_type);
     } else {
-        auto comptime_flags = symbol->flags & SYM_EXPORTED ? CTG_EXPORTED : CTG_NONE;
-        init_value = genComptime(aglobal.const_init, comptime_flags | CTG_UNWRAPPED, symbol->type);
+        init_value = genComptime(aglobal.const_init, CTG_UNWRAPPED, symbol->type);
     }
     
     bool exported = symbol->flags & SYM_EXPORTED;
@@ -364,11 +357,7 @@ void CodeGenerator::genGlobalVarDecl(Decl* decl) {
     );
     debug.EmitGlobalVariableInfo(decl, gv);
 
-    if (symbol->flags & SYM_CONST) {
-        symbol->flags ^= SYM_VAR | SYM_CONST;
-    }
-
-    symbol->llvm_value = gv;
+    symbol_values[symbol] = gv;
 }
 
 void CodeGenerator::genGlobalVarInit(HirDecl* node) {
@@ -382,7 +371,7 @@ void CodeGenerator::genGlobalVarInit(HirDecl* node) {
     setCurrentBlock(ll_init_block);
 
     ll_enclosing_func = ll_init_func;
-    genStoreExpr(node->ir_GlobalVar.init, node->ir_GlobalVar.symbol->llvm_value);
+    genStoreExpr(node->ir_GlobalVar.init, symbol_values.at(node->ir_GlobalVar.symbol));
     ll_enclosing_func = nullptr;
     
     ll_init_block = getCurrentBlock();
@@ -393,20 +382,35 @@ void CodeGenerator::genGlobalVarInit(HirDecl* node) {
 void CodeGenerator::genGlobalConst(Decl* decl) {
     auto& hconst = decl->hir_decl->ir_GlobalConst;
 
-    ComptimeGenFlags comptime_flags = CTG_CONST;
-    if (hconst.symbol->flags & SYM_EXPORTED) {
-        comptime_flags |= CTG_EXPORTED;
-    }
-
-    hconst.symbol->llvm_value = genComptime(hconst.init, comptime_flags, hconst.symbol->type);
+    symbol_values[hconst.symbol] = genComptime(hconst.init, CTG_CONST, hconst.symbol->type);
 }
 
 /* -------------------------------------------------------------------------- */
 
 std::string CodeGenerator::mangleName(std::string_view name) {
-    return std::format("_br7${}.{}.{}", src_mod.id, src_mod.name, name);
+    return MangleName(src_mod, name);
 }
 
 std::string CodeGenerator::mangleName(Module& imported_bry_mod, std::string_view name) {
-    return std::format("_br7${}.{}.{}", imported_bry_mod.id, imported_bry_mod.name, name);
+    return MangleName(imported_bry_mod, name);
+}
+
+std::string CodeGenerator::MangleName(Module& bry_mod, std::string_view name) {
+    return std::format("_br7${}.{}.{}", bry_mod.id, bry_mod.name, name);
+}
+
+std::string CodeGenerator::GetFuncLLName(Module& bry_mod, Decl* decl) {
+    auto* symbol = decl->hir_decl->ir_Func.symbol;
+
+    for (auto& attr : decl->attrs) {
+        if (attr.name == "extern" || attr.name == "abientry") {
+            return std::string(attr.value.size() == 0 ? symbol->name : attr.value);
+        }
+    }
+
+    return MangleName(bry_mod, symbol->name);
+}
+
+std::string CodeGenerator::GetInitFuncName(Module& bry_mod) {
+    return std::format("__berry_initmod${}", bry_mod.id);
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "codegen.hpp"
+#include "stats.hpp"
 
 static std::unordered_map<HirMemoryOrder, llvm::AtomicOrdering> hir_amo_to_llvm_amo {
     { HIRAMO_RELAXED, llvm::AtomicOrdering::Monotonic },
@@ -110,7 +111,7 @@ llvm::Value* CodeGenerator::genExpr(HirExpr* node, bool expect_addr, llvm::Value
         auto* ll_value = genExpr(node->ir_MacroAtomicLoad.expr);
 
         auto* ll_load_inst = irb.CreateLoad(ll_elem_type, ll_value);
-        ll_load_inst->setAtomic(hir_amo_to_llvm_amo[node->ir_MacroAtomicLoad.mo]);
+        ll_load_inst->setAtomic(hir_amo_to_llvm_amo.at(node->ir_MacroAtomicLoad.mo));
 
         return ll_load_inst;
     } break;
@@ -122,7 +123,7 @@ llvm::Value* CodeGenerator::genExpr(HirExpr* node, bool expect_addr, llvm::Value
         auto* ll_value = genExpr(node->ir_MacroAtomicStore.value);
 
         auto* ll_store_inst = irb.CreateStore(ll_value, ll_dest);
-        ll_store_inst->setAtomic(hir_amo_to_llvm_amo[node->ir_MacroAtomicStore.mo]);
+        ll_store_inst->setAtomic(hir_amo_to_llvm_amo.at(node->ir_MacroAtomicStore.mo));
 
         return ll_store_inst;
     } break;
@@ -143,8 +144,8 @@ llvm::Value* CodeGenerator::genAtomicCas(HirExpr* node) {
     auto* ll_expected_addr = genExpr(node->ir_MacroAtomicCas.expected);
     auto* ll_expected = irb.CreateLoad(ll_desired->getType(), ll_expected_addr);
 
-    auto ll_succ_mo = hir_amo_to_llvm_amo[node->ir_MacroAtomicCas.mo_succ];
-    auto ll_fail_mo = hir_amo_to_llvm_amo[node->ir_MacroAtomicCas.mo_fail];
+    auto ll_succ_mo = hir_amo_to_llvm_amo.at(node->ir_MacroAtomicCas.mo_succ);
+    auto ll_fail_mo = hir_amo_to_llvm_amo.at(node->ir_MacroAtomicCas.mo_fail);
 
     auto* ll_cas_result = irb.CreateAtomicCmpXchg(
         ll_atomic_val,
@@ -660,6 +661,7 @@ llvm::Value* CodeGenerator::genUnop(HirExpr* node) {
 
 void CodeGenerator::genDivideByZeroCheck(llvm::Value* divisor, Type* int_type) {
     auto* is_zero_val = irb.CreateICmpEQ(divisor, makeLLVMIntLit(int_type, 0));
+    CountStat(STAT_DIVIDE_CHECKS);
     is_zero_val = genLLVMExpect(is_zero_val, makeLLVMIntLit(&prim_bool_type, 0));
 
     auto* bb_zero = appendBlock();
@@ -682,6 +684,7 @@ void CodeGenerator::genDivideOverflowCheck(llvm::Value* dividend, llvm::Value* d
     uint64_t max_neg_int = 1 << (int_type->ty_Int.bit_size - 1); 
     auto* is_max_neg_int = irb.CreateICmpEQ(dividend, makeLLVMIntLit(int_type, max_neg_int));
     auto* is_neg_one = irb.CreateICmpEQ(divisor, makeLLVMIntLit(int_type, -1));
+    CountStat(STAT_OVERFLOW_CHECKS);
 
     auto* is_div_overflow = irb.CreateAnd(is_max_neg_int, is_neg_one);
     is_div_overflow = genLLVMExpect(is_div_overflow, makeLLVMIntLit(&prim_bool_type, 0));
@@ -703,6 +706,7 @@ void CodeGenerator::genDivideOverflowCheck(llvm::Value* dividend, llvm::Value* d
 
 void CodeGenerator::genShiftOverflowCheck(llvm::Value* rhs, Type* int_type) {
     auto* is_good_shift = irb.CreateICmpULT(rhs, makeLLVMIntLit(int_type, int_type->ty_Int.bit_size));
+    CountStat(STAT_OVERFLOW_CHECKS);
     is_good_shift = genLLVMExpect(is_good_shift, makeLLVMIntLit(&prim_bool_type, 1));
 
     auto* bb_bad_shift = appendBlock();
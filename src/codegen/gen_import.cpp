@@ -23,7 +23,7 @@ void CodeGenerator::genImports() {
             case HIR_GLOBAL_CONST: {
                 auto* ll_const = genComptime(
                     hir_decl->ir_GlobalConst.init, 
-                    CTG_EXPORTED, 
+                    CTG_CONST, 
                     hir_decl->ir_GlobalConst.symbol->type
                 );
 
@@ -50,24 +50,17 @@ llvm::Value* CodeGenerator::genImportFunc(Module& imported_mod, Decl* decl) {
 
     auto* ll_func_type = genFuncType(symbol->type);
 
-    std::string ll_name {};
     llvm::CallingConv::ID cconv = llvm::CallingConv::C;
     for (auto& attr : decl->attrs) {
-        if (attr.name == "extern" || attr.name == "abientry") {
-            ll_name = attr.value.size() == 0 ? symbol->name : attr.value;
-        } else if (attr.name == "callconv") {
-            cconv = cconv_name_to_id[attr.value];
+        if (attr.name == "callconv") {
+            cconv = cconv_name_to_id.at(attr.value);
         }
     }
 
-    if (ll_name.size() == 0) {
-        ll_name = mangleName(imported_mod, symbol->name);
-    }
-
     auto* ll_func = llvm::Function::Create(
         ll_func_type, 
         llvm::Function::ExternalLinkage,
-        ll_name,
+        GetFuncLLName(imported_mod, decl),
         mod
     );
 
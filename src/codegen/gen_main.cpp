@@ -29,19 +29,19 @@ MainBuilder::MainBuilder(llvm::LLVMContext& ctx, llvm::Module& main_mod)
     irb.SetInsertPoint(rt_main_block);
 }
 
-void MainBuilder::GenInitCall(llvm::Function* ll_init_func) {
+void MainBuilder::GenInitCall(Module& bry_mod) {
     // Add init call to the main module.
     auto* ll_init_func_stub = llvm::Function::Create(
-        dyn_cast<llvm::Function>(ll_init_func)->getFunctionType(),
+        rt_stub_func_type,
         llvm::Function::ExternalLinkage,
-        ll_init_func->getName(),
+        CodeGenerator::GetInitFuncName(bry_mod),
         main_mod
     );
 
     irb.CreateCall(ll_init_func_stub);
 }
 
-void MainBuilder::GenUserMainCall(Module& root_mod) {        
+void MainBuilder::GenUserMainCall(Module& root_mod) {
     // Check that a valid main function exists.
     auto it = root_mod.symbol_table.find("main");
     if (it == root_mod.symbol_table.end()) {
@@ -53,29 +53,38 @@ void MainBuilder::GenUserMainCall(Module& root_mod) {
         ReportFatal("input module does not have a main function");
     }
 
+    auto* decl = root_mod.decls[sym->decl_num];
     if (sym->type->ty_Func.param_types.size() != 0 || sym->type->ty_Func.return_type->kind != TYPE_UNIT) {
-        auto* decl = root_mod.decls[sym->decl_num];
         auto& src_file = root_mod.files[decl->file_num];
         
         ReportCompileError(src_file.display_path, sym->span, "main function must take no arguments and return no value");
     }
 
-    // Make sure the main function is externally visible (so we can call it).
-    Assert(llvm::Function::classof(sym->llvm_value), "main function is not an llvm::Function");
-    auto* foreign_main_func = llvm::dyn_cast<llvm::Function>(sym->llvm_value);
-    foreign_main_func->setLinkage(llvm::Function::ExternalLinkage);
-
-    // Insert the call to the main function.
+    // Insert the call to the main function.  The root module may have been
+    // loaded from the build cache, so the main function is referred to only by
+    // name: ExportUserMain makes sure the definition is visible.
     auto* user_main_func = llvm::Function::Create(
         rt_stub_func_type, 
         llvm::Function::ExternalLinkage, 
-        foreign_main_func->getName(), 
+        CodeGenerator::GetFuncLLName(root_mod, decl), 
         main_mod
     );
     
     irb.CreateCall(user_main_func);
 }
 
+void MainBuilder::ExportUserMain(Module& root_mod, llvm::Module& root_ll_mod) {
+    auto it = root_mod.symbol_table.find("main");
+    if (it == root_mod.symbol_table.end()) {
+        return;
+    }
+
+    auto* decl = root_mod.decls[it->second->decl_num];
+    auto* foreign_main_func = root_ll_mod.getFunction(CodeGenerator::GetFuncLLName(root_mod, decl));
+    Assert(foreign_main_func != nullptr, "main function is not an llvm::Function");
+    foreign_main_func->setLinkage(llvm::Function::ExternalLinkage);
+}
+
 void MainBuilder::FinishMain() {
     irb.CreateRetVoid();
 }
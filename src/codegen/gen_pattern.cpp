@@ -83,7 +83,7 @@ void CodeGenerator::pmGenCapture(Symbol* capture_sym, llvm::Value* match_operand
         irb.CreateStore(match_operand, capture);
     }
 
-    capture_sym->llvm_value = capture;
+    symbol_values[capture_sym] = capture;
 
     setCurrentBlock(prev_block);
 }
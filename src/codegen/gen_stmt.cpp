@@ -32,7 +32,7 @@ void CodeGenerator::genStmt(HirStmt* node) {
         auto* symbol = hlocal.symbol;
 
         auto* ll_var = genAlloc(symbol->type, HIRMEM_STACK);
-        symbol->llvm_value = ll_var;
+        symbol_values[symbol] = ll_var;
 
         debug.EmitLocalVariableInfo(node, ll_var);
 
@@ -43,7 +43,7 @@ void CodeGenerator::genStmt(HirStmt* node) {
     case HIR_LOCAL_CONST: {
         auto& hlocal = node->ir_LocalConst;
 
-        hlocal.symbol->llvm_value = genComptime(hlocal.init, CTG_CONST, hlocal.symbol->type);
+        symbol_values[hlocal.symbol] = genComptime(hlocal.init, CTG_CONST, hlocal.symbol->type);
     } break;
     case HIR_ASSIGN: {
         auto* lhs_addr = genExpr(node->ir_Assign.lhs, true);
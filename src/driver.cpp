@@ -4,6 +4,7 @@
 #include <fstream>
 #include <filesystem>
 #include <chrono>
+#include <algorithm>
 
 namespace fs = std::filesystem;
 
@@ -16,6 +17,8 @@ namespace fs = std::filesystem;
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/TargetParser/Host.h"
 #include "llvm/IR/LegacyPassManager.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Passes/OptimizationLevel.h"
 
 #include "loader.hpp"
 #include "parser.hpp"
@@ -23,37 +26,99 @@ namespace fs = std::filesystem;
 #include "codegen.hpp"
 #include "linker.hpp"
 #include "target.hpp"
+#include "thread_pool.hpp"
+#include "build_cache.hpp"
+#include "sha256.hpp"
+#include "fingerprint.hpp"
+#include "interface.hpp"
+#include "trace.hpp"
+#include "stats.hpp"
 
 /* -------------------------------------------------------------------------- */
 
+// LLModule is an LLVM module along with the context that owns it.  Each module
+// is generated in its own context since LLVM contexts are not thread-safe:
+// this allows modules to be generated, optimized, and emitted concurrently.
+struct LLModule {
+    // ctx must be declared before mod so that it is destroyed after it.
+    std::unique_ptr<llvm::LLVMContext> ctx;
+    std::unique_ptr<llvm::Module> mod;
+
+    // out_path is the path to write the output file to.
+    std::string out_path;
+
+    // cache_key is the build cache key of the module's object.  This is empty
+    // if the object isn't cached.
+    std::string cache_key;
+
+    // is_cached indicates whether the module's object was found in the build
+    // cache: the module doesn't need to be generated if it was.
+    bool is_cached { false };
+};
+
 class Compiler {
     const BuildConfig& cfg;
 
-    Arena arena;
-    Arena ast_arena;
+    // Modules are parsed and checked concurrently so the compiler's arenas are
+    // shared between workers.  Each module has its own AST and HIR arenas.
+    Arena arena { ARENA_GLOBAL, true };
     Loader loader;
 
+    // check_arena holds the symbols, types, and HIR created by the checker.
+    Arena check_arena { ARENA_CHECK, true };
+
+    // cache stores the objects generated for modules between builds.
+    BuildCache cache;
+
+    // decl_fingerprints caches the fingerprints of imported declarations.
+    std::unordered_map<Decl*, std::string> decl_fingerprints;
+
+    // config_key identifies the compiler and target configuration of cached
+    // objects and module interface files.
+    std::string config_key;
+
     std::vector<std::string> obj_files;
     std::string out_dir;
     bool should_delete_out_dir { false };
 
-    llvm::TargetMachine* tmach;
+    std::unique_ptr<llvm::TargetMachine> tmach;
 
     using Clock = std::chrono::steady_clock;
     using Second = std::chrono::duration<double, std::ratio<1>>;
 
     std::chrono::time_point<Clock> profile_start;
-    std::string profile_section;
+    const char* profile_section;
 
 public:
     Compiler(const BuildConfig& cfg)
     : cfg(cfg)
-    , loader(arena, ast_arena, cfg.import_paths)
+    , loader(arena, cfg.import_paths, getWorkerCount())
+    , cache(cfg.cache_dir)
     {
         initPlatform();
     }
 
     void Compile() {
+        if (cfg.snapshot_std) {
+            snapshotStd();
+            return;
+        }
+
+        // Objects can only be cached when they are the build output: assembly
+        // and LLVM IR are meant to be looked at.  Modules are only loaded from
+        // their interface files when their objects can be reused.
+        if (cfg.out_fmt != OUTFMT_ASM && cfg.out_fmt != OUTFMT_LLVM) {
+            config_key = computeConfigKey();
+
+            if (shouldCache()) {
+                cache.Open();
+                loader.EnableInterfaces(&cache, config_key, getOutputExt());
+            } else {
+                // The standard library snapshot can still be used.
+                loader.EnableInterfaces(nullptr, config_key, getOutputExt());
+            }
+        }
+
         startTimer("Loader");
         loader.LoadAll(cfg.input_path);
         endTimer();
@@ -71,6 +136,9 @@ public:
         }
 
         switch (cfg.out_fmt) {
+        case OUTFMT_CHECK:
+            // Only the diagnostics are wanted: nothing is generated.
+            break;
         case OUTFMT_EXE:
         case OUTFMT_STATIC:
         case OUTFMT_SHARED:
@@ -92,6 +160,38 @@ public:
         }
     }
 
+    // snapshotStd builds the snapshot of the standard library: the default
+    // modules are checked and generated from source, and their interface files
+    // and objects are written to the snapshot directory.  Every later build
+    // with the same configuration loads them from the snapshot instead.
+    void snapshotStd() {
+        cache = BuildCache(Loader::GetStdSnapshotDir());
+        cache.Open();
+        config_key = computeConfigKey();
+
+        startTimer("Loader");
+        loader.LoadStd();
+        endTimer();
+
+        if (ErrorCount() > 0) {
+            return;
+        }
+
+        startTimer("Checker");
+        check();
+        endTimer();
+
+        if (ErrorCount() > 0) {
+            return;
+        }
+
+        out_dir = ".berry-temp";
+        should_delete_out_dir = true;
+        prepareOutDir();
+
+        emit();
+    }
+
     ~Compiler() {
         if (should_delete_out_dir) {
             std::error_code ec;
@@ -104,12 +204,80 @@ public:
 
 private:
     void check() {
-        for (auto* mod : loader.SortModulesByDepGraph()) {
-            Checker c(arena, *mod); 
-            c.CheckModule();
+        // A module can be checked as soon as all of its dependencies have been
+        // checked.  Thus, the modules are grouped into waves by their depth in
+        // the dependency graph, and all the modules in a wave are checked
+        // concurrently.  Within a wave, modules are kept in sorted order.
+        auto& sorted_mods = loader.SortModulesByDepGraph();
+
+        std::vector<size_t> mod_depths(sorted_mods.size(), 0);
+        std::vector<std::vector<Module*>> waves;
+        for (auto* mod : sorted_mods) {
+            // Modules loaded from their interface files are already checked.
+            if (mod->from_interface) {
+                continue;
+            }
+
+            size_t depth = 0;
+            for (auto& dep : mod->deps) {
+                depth = std::max(depth, mod_depths[dep.mod->id] + 1);
+            }
+
+            mod_depths[mod->id] = depth;
+            if (waves.size() <= depth) {
+                waves.resize(depth + 1);
+            }
+
+            waves[depth].push_back(mod);
         }
 
-        ast_arena.Release();
+        for (auto& wave : waves) {
+            std::vector<std::unique_ptr<Checker>> checkers(wave.size());
+            std::vector<DiagnosticBuffer> diag_buffs(wave.size());
+            std::vector<char> failed(wave.size(), false);
+
+            // ParallelFor starts its own threads, so the workers are split
+            // between the modules of the wave: a wave never runs more threads
+            // in total than there are workers.  Waves with at least as many
+            // modules as workers check their bodies sequentially.
+            size_t n_body_workers = std::max(getWorkerCount() / wave.size(), (size_t)1);
+
+            // Every module in the wave is checked to completion even if one of
+            // them fails so that the errors reported don't depend on timing.
+            ParallelFor(getWorkerCount(), wave.size(), [&](size_t, size_t i) {
+                CaptureDiagnostics capture(diag_buffs[i]);
+
+                TraceScope trace_scope("Check Module", wave[i]->name);
+
+                checkers[i] = std::make_unique<Checker>(check_arena, *wave[i]);
+                if (cfg.parallel_check_bodies) {
+                    checkers[i]->EnableParallelBodies(n_body_workers);
+                }
+
+                try {
+                    checkers[i]->CheckModule();
+                } catch (CompileError&) {
+                    failed[i] = true;
+                }
+
+                releaseAST(*wave[i]);
+            });
+
+            bool wave_failed = false;
+            for (size_t i = 0; i < wave.size(); i++) {
+                if (!failed[i]) {
+                    CaptureDiagnostics capture(diag_buffs[i]);
+                    checkers[i]->MergeForeignBindings();
+                }
+
+                diag_buffs[i].Flush();
+                wave_failed = wave_failed || failed[i];
+            }
+
+            if (wave_failed) {
+                throw CompileError{};
+            }
+        }
 
         if (ErrorCount() > 0) {
             throw CompileError{};
@@ -117,88 +285,293 @@ private:
     }
 
     void emit() {
+        initBackend();
+
         auto& tp = GetTargetPlatform();
-                      
-        // The modules in this vector have to be unique pointers because it
-        // seems like for whatever reason, the LLVM api deletes both the copy
-        // and the move constructor of llvm::Module, so it is impossible to
-        // store them directly in a vector.  This is my hypothesis anyway; at
-        // any rate, any version of this code that stores the LLVM modules as
-        // values won't compile (results a slurry of C++ template errors).
-        std::vector<std::unique_ptr<llvm::Module>> ll_mods;
-
-        // Create the main module.
-        auto& main_mod = *ll_mods.emplace_back(std::make_unique<llvm::Module>("_$berry_main", tp.ll_context));
-        main_mod.setDataLayout(tmach->createDataLayout());
-        main_mod.setTargetTriple(tmach->getTargetTriple().str());
+        auto mods = loader.SortModulesByDepGraph();
+
+        auto file_ext = getOutputExt();
+        bool should_cache = shouldCache();
+
+        // The main module is always first followed by the user modules in
+        // dependency order: this keeps the output (and link order) the same
+        // regardless of how many workers are used.
+        std::vector<LLModule> ll_mods(mods.size() + 1);
+        for (size_t i = 0; i < ll_mods.size(); i++) {
+            auto& ll_mod = ll_mods[i];
+
+            auto mod_name = i == 0 ? std::string("_$berry_main") : std::format("m{}-{}", mods[i-1]->id, mods[i-1]->name);
+            ll_mod.out_path = (fs::path(out_dir) / fs::path(mod_name + file_ext)).string();
+
+            // Modules loaded from their interface files always have a cached
+            // object: the loader checks for it.
+            if (i > 0 && mods[i-1]->from_interface) {
+                ll_mod.cache_key = mods[i-1]->obj_key;
+                ll_mod.is_cached = true;
+                useCachedObject(ll_mod, mods[i-1]->obj_path);
+                continue;
+            }
+
+            // The main module is cheap to generate and depends on every other
+            // module, so it is never cached.
+            if (i > 0 && should_cache) {
+                ll_mod.cache_key = computeCacheKey(*mods[i-1]);
+
+                if (!ll_mod.cache_key.empty() && cache.Contains(ll_mod.cache_key, file_ext)) {
+                    ll_mod.is_cached = true;
+                    useCachedObject(ll_mod, cache.GetObjectPath(ll_mod.cache_key, file_ext));
+                    continue;
+                }
+            }
+
+            ll_mod.ctx = std::make_unique<llvm::LLVMContext>();
+            ll_mod.mod = std::make_unique<llvm::Module>(mod_name, *ll_mod.ctx);
+            ll_mod.mod->setDataLayout(*tp.ll_layout);
+            ll_mod.mod->setTargetTriple(tp.ll_triple.str());
+
+            if (cfg.out_fmt != OUTFMT_LLVM && cfg.out_fmt != OUTFMT_ASM) {
+                obj_files.push_back(ll_mod.out_path);
+            }
+        }
 
+        auto n_workers = std::min(getWorkerCount(), ll_mods.size());
+
+        // Every module is fully checked at this point, and imported
+        // declarations are generated from the checked HIR of their defining
+        // module rather than from its LLVM module.  Thus, the user modules can
+        // be generated in any order with no synchronization between them.
         startTimer("CodeGen");
-        MainBuilder mainb(tp.ll_context, main_mod);
+        ParallelFor(n_workers, mods.size(), [&](size_t, size_t i) {
+            auto& ll_mod = ll_mods[i + 1];
+            if (!ll_mod.is_cached) {
+                TraceScope trace_scope("Generate Module", mods[i]->name);
 
-        // Generate all the user modules.
-        for (auto* mod : loader.SortModulesByDepGraph()) {
-            auto& ll_mod = ll_mods.emplace_back(std::make_unique<llvm::Module>(std::format("m{}-{}", mod->id, mod->name), tp.ll_context));
-            ll_mod->setDataLayout(*tp.ll_layout);
-            ll_mod->setTargetTriple(tp.ll_triple.str());
+                CodeGenerator cg(*ll_mod.ctx, *ll_mod.mod, *mods[i], cfg.should_emit_debug);
+                cg.GenerateModule();
+            }
 
-            CodeGenerator cg(tp.ll_context, *ll_mod, *mod, cfg.should_emit_debug, mainb, arena);
-            cg.GenerateModule();
+            // Generating other modules only requires the module's HIR
+            // declarations which are not stored in its HIR arena.
+            mods[i]->hir_arena.Release();
+        });
+
+        // The main module refers to the other modules only by name, so it is
+        // built after they have all been generated.
+        auto& main_mod = ll_mods[0];
+        MainBuilder mainb(*main_mod.ctx, *main_mod.mod);
+        for (auto* mod : mods) {
+            mainb.GenInitCall(*mod);
         }
 
-        if (cfg.out_fmt == OUTFMT_EXE) {
-            mainb.GenUserMainCall(loader.GetRootModule());
+        auto* root_mod = loader.GetRootModule();
+        if (cfg.out_fmt == OUTFMT_EXE && root_mod != nullptr) {
+            auto root_it = std::find(mods.begin(), mods.end(), root_mod);
+            Assert(root_it != mods.end(), "root module was not generated");
+
+            mainb.GenUserMainCall(*root_mod);
+
+            auto& root_ll_mod = ll_mods[root_it - mods.begin() + 1];
+            if (!root_ll_mod.is_cached) {
+                MainBuilder::ExportUserMain(*root_mod, *root_ll_mod.mod);
+            }
         }
 
         mainb.FinishMain();
         endTimer();
 
-        // Emit the modules to LLVM if that is our output format.
         startTimer("LLVM Compile");
-        std::error_code ec;
-        if (cfg.out_fmt == OUTFMT_LLVM) {
-            for (auto& ll_mod : ll_mods) {
-                auto out_path = (fs::path(out_dir) / fs::path(ll_mod->getModuleIdentifier() + ".ll")).string();
 
-                llvm::raw_fd_ostream out_file(out_path, ec, llvm::sys::fs::OF_None);
-                if (ec) {
-                    ReportFatal("error: opening output file: {}", ec.message());
+        // Each worker gets its own target machine: they aren't thread-safe.
+        std::vector<std::unique_ptr<llvm::TargetMachine>> worker_tmachs;
+        for (size_t i = 0; i < n_workers; i++) {
+            worker_tmachs.emplace_back(createTargetMachine(tp.ll_triple.str()));
+        }
+
+        ParallelFor(n_workers, ll_mods.size(), [&](size_t worker_id, size_t i) {
+            auto& ll_mod = ll_mods[i];
+            if (ll_mod.is_cached) {
+                return;
+            }
+
+            auto& worker_tmach = *worker_tmachs[worker_id];
+
+            uint64_t n_funcs = 0, n_instrs = 0;
+            if (stats_enabled) {
+                countLLVMCode(*ll_mod.mod, n_funcs, n_instrs);
+            }
+
+            {
+                TraceScope trace_scope("Optimize Module", ll_mod.mod->getName());
+                optimizeModule(worker_tmach, *ll_mod.mod);
+            }
+
+            if (stats_enabled) {
+                uint64_t n_opt_funcs = 0, n_opt_instrs = 0;
+                countLLVMCode(*ll_mod.mod, n_opt_funcs, n_opt_instrs);
+                RecordModuleCodeStats(ll_mod.mod->getName(), n_funcs, n_instrs, n_opt_instrs);
+                countLLVMChecks(*ll_mod.mod);
+            }
+
+            {
+                TraceScope trace_scope("Emit Module", ll_mod.mod->getName());
+
+                if (cfg.out_fmt == OUTFMT_LLVM) {
+                    printModuleToFile(*ll_mod.mod, ll_mod.out_path);
+                } else {
+                    emitModuleToFile(worker_tmach, *ll_mod.mod, ll_mod.out_path, cfg.out_fmt == OUTFMT_ASM);
                 }
+            }
 
-                ll_mod->print(out_file, nullptr);
+            // Free the module (and its context) as soon as it is written.
+            ll_mod.mod.reset();
+            ll_mod.ctx.reset();
 
-                out_file.flush();
-                out_file.close();
+            if (!ll_mod.cache_key.empty()) {
+                cache.Store(ll_mod.cache_key, file_ext, ll_mod.out_path);
             }
+        });
 
+        endTimer();
+
+        if (should_cache) {
+            startTimer("Write Interfaces");
+            writeInterfaces(mods, ll_mods);
             endTimer();
-            return;
         }
+    }
 
-        // Otherwise, generate the appropriate output code using the target machine.
-        bool is_asm = cfg.out_fmt == OUTFMT_ASM;
+    // writeInterfaces writes the interface files of all the modules which were
+    // checked from source and have cached objects.  mods must be sorted in
+    // dependency order so that the fingerprints of each module's dependencies
+    // are computed before the module's interface is written.
+    void writeInterfaces(const std::vector<Module*>& mods, const std::vector<LLModule>& ll_mods) {
+        auto* root_mod = loader.GetRootModule();
+
+        for (size_t i = 0; i < mods.size(); i++) {
+            auto& mod = *mods[i];
+            if (mod.from_interface) {
+                continue;
+            }
 
-        std::string file_ext;
-        if (is_asm) {
-            file_ext = ".asm";
-        } else {
-            #if OS_WINDOWS
-                file_ext = ".obj";
-            #else
-                file_ext = ".o";
-            #endif
+            mod.fingerprint = FingerprintInterface(mod);
+
+            // The root module is always loaded from source.
+            auto& obj_key = ll_mods[i + 1].cache_key;
+            if (&mod == root_mod || obj_key.empty()) {
+                continue;
+            }
+
+            InterfaceHeader header;
+            header.config_key = config_key;
+            header.source_hash = mod.source_hash;
+            header.mod_id = mod.id;
+            header.fingerprint = mod.fingerprint;
+            header.obj_key = obj_key;
+
+            if (header.source_hash.empty()) {
+                continue;
+            }
+
+            for (auto& dep : mod.deps) {
+                header.deps.push_back({ dep.mod_path, dep.mod->id, dep.mod->fingerprint });
+            }
+
+            // Like the objects, interface files are only an optimization.
+            WriteInterface(cache.GetObjectPath(GetInterfaceKey(mod), BERRY_INTERFACE_EXT), mod, header);
+        }
+    }
+
+    // computeConfigKey computes the key identifying the compiler and target
+    // configuration: cached objects and interface files can only be used by a
+    // build with the same configuration.
+    std::string computeConfigKey() {
+        auto& tp = GetTargetPlatform();
+
+        Sha256 hasher;
+        hasher.Update(BERRYC_VERSION);
+        hasher.Update(tp.ll_triple.str());
+        hasher.Update(llvm::sys::getHostCPUName());
+        hasher.Update((uint64_t)cfg.opt_level);
+        hasher.Update((uint64_t)cfg.should_emit_debug);
+        hasher.Update((uint64_t)cfg.debug_fmt);
+        return hasher.HexDigest();
+    }
+
+    // computeCacheKey computes the build cache key of the object generated for
+    // mod.  The key covers everything that can change the contents of the
+    // object: the compiler and target configuration, the module's ID (which
+    // appears in mangled names), the module's source text, and the interfaces
+    // of the declarations it imports.  This returns an empty string if the
+    // module can't be cached.
+    std::string computeCacheKey(Module& mod) {
+        Sha256 hasher;
+        hasher.Update(config_key);
+
+        hasher.Update((uint64_t)mod.id);
+        hasher.Update(mod.name);
+
+        // The user's main function is only exported from the root module of
+        // an executable.
+        bool exports_main = cfg.out_fmt == OUTFMT_EXE && &mod == loader.GetRootModule();
+        hasher.Update((uint64_t)exports_main);
+
+        if (mod.source_hash.empty()) {
+            return "";
         }
 
-        for (auto& ll_mod : ll_mods) {
-            auto out_path = (fs::path(out_dir) / fs::path(ll_mod->getModuleIdentifier() + file_ext)).string();
-                
-            emitModuleToFile(ll_mod, out_path, is_asm);
+        hasher.Update(mod.source_hash);
+
+        // Only the fingerprints of the imported declarations are hashed so that
+        // changes to a dependency which don't affect its interface (eg. to the
+        // body of a function) don't invalidate the module.
+        for (auto& dep : mod.deps) {
+            std::vector<std::string> used_fingerprints;
+            for (auto decl_num : dep.usages) {
+                used_fingerprints.push_back(getDeclFingerprint(*dep.mod, decl_num));
+            }
+
+            // The usages are unordered.
+            std::sort(used_fingerprints.begin(), used_fingerprints.end());
 
-            if (!is_asm) {
-                obj_files.push_back(out_path);
+            hasher.Update((uint64_t)dep.mod->id);
+            hasher.Update((uint64_t)used_fingerprints.size());
+            for (auto& fingerprint : used_fingerprints) {
+                hasher.Update(fingerprint);
             }
         }
 
-        endTimer();
+        return hasher.HexDigest();
+    }
+
+    // getDeclFingerprint returns the fingerprint of the declaration of mod
+    // numbered decl_num.
+    const std::string& getDeclFingerprint(Module& mod, size_t decl_num) {
+        auto* decl = mod.decls[decl_num];
+
+        auto it = decl_fingerprints.find(decl);
+        if (it == decl_fingerprints.end()) {
+            it = decl_fingerprints.emplace(decl, FingerprintDecl(mod, decl)).first;
+        }
+
+        return it->second;
+    }
+
+    // useCachedObject makes the build use the cached object at cached_path for
+    // ll_mod.
+    void useCachedObject(LLModule& ll_mod, const std::string& cached_path) {
+        if (cfg.out_fmt == OUTFMT_OBJ) {
+            // The objects are the build output, so they have to be copied.
+            std::error_code ec;
+            fs::copy_file(cached_path, ll_mod.out_path, fs::copy_options::overwrite_existing, ec);
+            if (ec) {
+                ReportFatal("failed to copy cached object: {}", ec.message());
+            }
+
+            obj_files.push_back(ll_mod.out_path);
+        } else {
+            // The cached object can be linked directly.
+            obj_files.push_back(cached_path);
+        }
     }
 
     void link() {
@@ -269,8 +642,17 @@ private:
             ReportFatal("unsupported architecture: {}", tp.ll_triple.getArchName().str());
         }
 
+        tp.InitLayoutModel();
+    }
+
+    // initBackend initializes the LLVM target and creates the target machine.
+    // This is deferred until code generation so that check-only builds never
+    // touch the LLVM backend.
+    void initBackend() {
+        auto& tp = GetTargetPlatform();
+
         initTargets();
-        tmach = createTargetMachine(str_triple);
+        tmach.reset(createTargetMachine(tp.ll_triple.str()));
         tp.ll_layout = arena.New<llvm::DataLayout>(tmach->createDataLayout());
     }
 
@@ -301,11 +683,138 @@ private:
             march, 
             "", 
             target_opt, 
-            llvm::Reloc::PIC_
+            llvm::Reloc::PIC_,
+            std::nullopt,
+            getCodeGenOptLevel()
         );
     }
 
-    void emitModuleToFile(std::unique_ptr<llvm::Module>& ll_mod, const std::string& out_path, bool is_asm) {
+    llvm::CodeGenOpt::Level getCodeGenOptLevel() {
+        switch (cfg.opt_level) {
+        case OPTLVL_O0:
+            return llvm::CodeGenOpt::None;
+        case OPTLVL_O1:
+            return llvm::CodeGenOpt::Less;
+        case OPTLVL_O3:
+            return llvm::CodeGenOpt::Aggressive;
+        default:
+            // Like clang, -Os and -Oz use the default code generation level:
+            // size is handled by the IR optimization pipeline.
+            return llvm::CodeGenOpt::Default;
+        }
+    }
+
+    llvm::OptimizationLevel getIROptLevel() {
+        switch (cfg.opt_level) {
+        case OPTLVL_O0:
+            return llvm::OptimizationLevel::O0;
+        case OPTLVL_O1:
+            return llvm::OptimizationLevel::O1;
+        case OPTLVL_O2:
+            return llvm::OptimizationLevel::O2;
+        case OPTLVL_O3:
+            return llvm::OptimizationLevel::O3;
+        case OPTLVL_OS:
+            return llvm::OptimizationLevel::Os;
+        case OPTLVL_OZ:
+            return llvm::OptimizationLevel::Oz;
+        default:
+            Panic("invalid optimization level: {}", (int)cfg.opt_level);
+        }
+    }
+
+    // countLLVMCode counts the functions defined in ll_mod and the number of
+    // instructions in them.
+    void countLLVMCode(llvm::Module& ll_mod, uint64_t& n_funcs, uint64_t& n_instrs) {
+        for (auto& func : ll_mod) {
+            if (!func.isDeclaration()) {
+                n_funcs++;
+                n_instrs += func.getInstructionCount();
+            }
+        }
+    }
+
+    // countLLVMChecks counts the runtime checks kept in ll_mod after it has been
+    // optimized.  Every check which survives still calls its panic stub.
+    void countLLVMChecks(llvm::Module& ll_mod) {
+        static const std::pair<const char*, StatCounter> check_stubs[] = {
+            { "__berry_panicOOB", STAT_BOUNDS_CHECKS_KEPT },
+            { "__berry_panicOverflow", STAT_OVERFLOW_CHECKS_KEPT },
+            { "__berry_panicDivide", STAT_DIVIDE_CHECKS_KEPT },
+        };
+
+        for (auto& [stub_name, counter] : check_stubs) {
+            auto* stub_func = ll_mod.getFunction(stub_name);
+            if (stub_func == nullptr) {
+                continue;
+            }
+
+            uint64_t n_calls = 0;
+            for (auto* user : stub_func->users()) {
+                if (llvm::isa<llvm::CallInst>(user)) {
+                    n_calls++;
+                }
+            }
+
+            CountStat(counter, n_calls);
+        }
+    }
+
+    void optimizeModule(llvm::TargetMachine& worker_tmach, llvm::Module& ll_mod) {
+        // The analysis managers have to be declared in this order so that they
+        // are destroyed in the reverse order of their dependencies.
+        llvm::LoopAnalysisManager lam;
+        llvm::FunctionAnalysisManager fam;
+        llvm::CGSCCAnalysisManager cgam;
+        llvm::ModuleAnalysisManager mam;
+
+        // Each pass which runs for long enough is recorded in the time trace.
+        llvm::PassInstrumentationCallbacks pic;
+        if (trace_enabled) {
+            pic.registerBeforeNonSkippedPassCallback([](llvm::StringRef pass_name, llvm::Any) {
+                BeginTraceSpan(pass_name, "", TRACE_GRANULARITY_US);
+            });
+            pic.registerAfterPassCallback([](llvm::StringRef, llvm::Any, const llvm::PreservedAnalyses&) {
+                EndTraceSpan();
+            });
+            pic.registerAfterPassInvalidatedCallback([](llvm::StringRef, const llvm::PreservedAnalyses&) {
+                EndTraceSpan();
+            });
+        }
+
+        llvm::PassBuilder pb(&worker_tmach, llvm::PipelineTuningOptions(), std::nullopt, &pic);
+        pb.registerModuleAnalyses(mam);
+        pb.registerCGSCCAnalyses(cgam);
+        pb.registerFunctionAnalyses(fam);
+        pb.registerLoopAnalyses(lam);
+        pb.crossRegisterProxies(lam, fam, cgam, mam);
+
+        auto ir_opt_level = getIROptLevel();
+
+        llvm::ModulePassManager mpm;
+        if (ir_opt_level == llvm::OptimizationLevel::O0) {
+            mpm = pb.buildO0DefaultPipeline(ir_opt_level);
+        } else {
+            mpm = pb.buildPerModuleDefaultPipeline(ir_opt_level);
+        }
+
+        mpm.run(ll_mod, mam);
+    }
+
+    void printModuleToFile(llvm::Module& ll_mod, const std::string& out_path) {
+        std::error_code ec;
+        llvm::raw_fd_ostream out_file(out_path, ec, llvm::sys::fs::OF_None);
+        if (ec) {
+            ReportFatal("error: opening output file: {}", ec.message());
+        }
+
+        ll_mod.print(out_file, nullptr);
+
+        out_file.flush();
+        out_file.close();
+    }
+
+    void emitModuleToFile(llvm::TargetMachine& worker_tmach, llvm::Module& ll_mod, const std::string& out_path, bool is_asm) {
         std::error_code ec;
         llvm::raw_fd_ostream out_file(out_path, ec, llvm::sys::fs::OF_None);
         if (ec) {
@@ -314,11 +823,11 @@ private:
 
         llvm::legacy::PassManager pass;
         auto file_type = is_asm ? llvm::CodeGenFileType::CGFT_AssemblyFile : llvm::CodeGenFileType::CGFT_ObjectFile;
-        if (tmach->addPassesToEmitFile(pass, out_file, nullptr, file_type)) {
+        if (worker_tmach.addPassesToEmitFile(pass, out_file, nullptr, file_type)) {
             ReportFatal("target machine was unable to generate output file\n");
         }
 
-        pass.run(*ll_mod);
+        pass.run(ll_mod);
         out_file.flush();
 
         // LLVM wants to do this automatically and throws a random assertion
@@ -328,6 +837,35 @@ private:
         // out_file.close();  
     }
 
+    // shouldCache returns whether generated objects should be cached.
+    bool shouldCache() {
+        if (cfg.snapshot_std) {
+            return true;
+        }
+
+        return !cfg.cache_dir.empty() && cfg.out_fmt != OUTFMT_ASM && cfg.out_fmt != OUTFMT_LLVM;
+    }
+
+    // getOutputExt returns the file extension of the generated output files.
+    std::string getOutputExt() {
+        switch (cfg.out_fmt) {
+        case OUTFMT_LLVM:
+            return ".ll";
+        case OUTFMT_ASM:
+            return ".asm";
+        default:
+            #if OS_WINDOWS
+                return ".obj";
+            #else
+                return ".o";
+            #endif
+        }
+    }
+
+    size_t getWorkerCount() {
+        return cfg.n_jobs > 0 ? (size_t)cfg.n_jobs : GetDefaultWorkerCount();
+    }
+
     /* ---------------------------------------------------------------------- */
 
     void prepareOutDir() {
@@ -345,25 +883,90 @@ private:
         }
     }
 
-    void startTimer(const std::string& section) {
+    // startTimer starts timing a top-level phase of the compilation.  Phases
+    // are recorded in the time trace, and their durations are printed in
+    // verbose mode.  If the phase fails, its span is dropped from the trace.
+    void startTimer(const char* section) {
         profile_section = section;
         profile_start = Clock::now();
+
+        if (trace_enabled) {
+            BeginTraceSpan(section);
+        }
     }
 
     void endTimer() {
-        auto diff = std::chrono::duration_cast<Second>(Clock::now() - profile_start).count();
-        std::cout << "[PROFILE] " << profile_section << " ";
-        printf("%.2f ms\n", diff * 1000.0f);
+        if (trace_enabled) {
+            EndTraceSpan();
+        }
+
+        if (cfg.verbose) {
+            auto diff = std::chrono::duration_cast<Second>(Clock::now() - profile_start).count();
+            std::cout << "[PROFILE] " << profile_section << " ";
+            printf("%.2f ms\n", diff * 1000.0f);
+        }
+
+        printMemReport(profile_section);
+    }
+
+    // releaseAST releases the AST of mod once it has been checked: only the
+    // module's own checker uses it.
+    void releaseAST(Module& mod) {
+        for (auto* decl : mod.decls) {
+            decl->ast_decl = nullptr;
+        }
+
+        mod.ast_arena.Release();
+    }
+
+    // printMemReport prints the memory used by all the compiler's arenas at the
+    // end of the given phase if memory reports are enabled.
+    void printMemReport(const char* phase) {
+        if (!cfg.mem_report) {
+            return;
+        }
+
+        ArenaReport report;
+        report.Add(arena);
+        report.Add(GetNameArena());
+        report.Add(check_arena);
+
+        for (auto& mod : loader) {
+            report.Add(mod.ast_arena);
+            report.Add(mod.hir_arena);
+        }
+        report.Print(phase);
     }
 };
 
 bool Compile(const BuildConfig& cfg) {
-    Compiler c(cfg);
+    bool should_trace = !cfg.time_trace_path.empty();
+    if (should_trace) {
+        StartTrace();
+    }
 
+    if (cfg.show_stats) {
+        StartStats();
+    }
+
+    // The compiler is constructed inside the try since setting it up can
+    // already report fatal errors.
+    bool build_ok;
     try {
+        Compiler c(cfg);
         c.Compile();
-        return ErrorCount() == 0;
+        build_ok = ErrorCount() == 0;
     } catch (CompileError&) {
-        return false;
+        build_ok = false;
+    }
+
+    if (should_trace) {
+        FinishTrace(cfg.time_trace_path);
     }
+
+    if (cfg.show_stats) {
+        PrintStats();
+    }
+
+    return build_ok;
 }
\ No newline at end of file
@@ -0,0 +1,266 @@
+#include "fingerprint.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+#include "sha256.hpp"
+
+// InterfaceHasher hashes the parts of declarations which are visible to other
+// modules.
+class InterfaceHasher {
+    Sha256 hasher;
+
+    // visited_types stores the named types which have already been hashed.
+    // Named types can be recursive, so later occurrences of a named type are
+    // only hashed by name.
+    std::unordered_set<Type*> visited_types;
+
+public:
+    void HashDecl(Module& mod, Decl* decl);
+
+    inline std::string Finish() { return hasher.HexDigest(); }
+
+private:
+    void hashType(Type* type);
+    void hashConst(ConstValue* value);
+    void hashAttrs(Decl* decl);
+};
+
+void InterfaceHasher::HashDecl(Module& mod, Decl* decl) {
+    auto* hdecl = decl->hir_decl;
+
+    hasher.Update((uint64_t)mod.id);
+    hasher.Update(mod.name);
+    hasher.Update((uint64_t)hdecl->kind);
+    hasher.Update((uint64_t)decl->flags);
+    hashAttrs(decl);
+
+    switch (hdecl->kind) {
+    case HIR_FUNC:
+        hasher.Update(hdecl->ir_Func.symbol->name);
+        hashType(hdecl->ir_Func.symbol->type);
+        break;
+    case HIR_METHOD:
+        hashType(hdecl->ir_Method.bind_type);
+        hasher.Update(hdecl->ir_Method.method->name);
+        hashType(hdecl->ir_Method.method->signature);
+        break;
+    case HIR_FACTORY:
+        hashType(hdecl->ir_Factory.bind_type);
+        hashType(hdecl->ir_Factory.func->signature);
+        break;
+    case HIR_GLOBAL_VAR:
+        hasher.Update(hdecl->ir_GlobalVar.symbol->name);
+        hashType(hdecl->ir_GlobalVar.symbol->type);
+        break;
+    case HIR_GLOBAL_CONST:
+        hasher.Update(hdecl->ir_GlobalConst.symbol->name);
+        hashType(hdecl->ir_GlobalConst.symbol->type);
+        hashConst(hdecl->ir_GlobalConst.init);
+        break;
+    case HIR_STRUCT:
+    case HIR_ALIAS:
+    case HIR_ENUM:
+        hasher.Update(hdecl->ir_TypeDef.symbol->name);
+        hashType(hdecl->ir_TypeDef.symbol->type);
+        break;
+    default:
+        Panic("fingerprinting not implemented for {}", (int)hdecl->kind);
+    }
+}
+
+void InterfaceHasher::hashType(Type* type) {
+    if (type->kind == TYPE_UNTYP) {
+        Assert(type->ty_Untyp.concrete_type != nullptr, "fingerprinting uninferred untyped");
+        type = type->ty_Untyp.concrete_type;
+    }
+
+    hasher.Update((uint64_t)type->kind);
+
+    switch (type->kind) {
+    case TYPE_INT:
+        hasher.Update((uint64_t)type->ty_Int.bit_size);
+        hasher.Update((uint64_t)type->ty_Int.is_signed);
+        break;
+    case TYPE_FLOAT:
+        hasher.Update((uint64_t)type->ty_Float.bit_size);
+        break;
+    case TYPE_BOOL:
+    case TYPE_UNIT:
+    case TYPE_STRING:
+        break;
+    case TYPE_PTR:
+        hashType(type->ty_Ptr.elem_type);
+        break;
+    case TYPE_FUNC:
+        hasher.Update((uint64_t)type->ty_Func.param_types.size());
+        for (auto* param_type : type->ty_Func.param_types) {
+            hashType(param_type);
+        }
+
+        hashType(type->ty_Func.return_type);
+        break;
+    case TYPE_ARRAY:
+        hasher.Update(type->ty_Array.len);
+        hashType(type->ty_Array.elem_type);
+        break;
+    case TYPE_SLICE:
+        hashType(type->ty_Slice.elem_type);
+        break;
+    case TYPE_NAMED:
+    case TYPE_ALIAS:
+        hasher.Update((uint64_t)type->ty_Named.mod_id);
+        hasher.Update(type->ty_Named.mod_name);
+        hasher.Update(type->ty_Named.name);
+
+        if (!visited_types.contains(type)) {
+            visited_types.insert(type);
+            hashType(type->ty_Named.type);
+        }
+        break;
+    case TYPE_STRUCT:
+        hasher.Update((uint64_t)type->ty_Struct.fields.size());
+        for (auto& field : type->ty_Struct.fields) {
+            hasher.Update(field.name);
+            hasher.Update((uint64_t)field.exported);
+            hashType(field.type);
+        }
+        break;
+    case TYPE_ENUM: {
+        // The variants have to be hashed in a stable order.
+        std::vector<std::pair<std::string_view, uint64_t>> variants;
+        type->ty_Enum.tag_map.for_each([&](std::string_view name, uint64_t tag) {
+            variants.push_back({ name, tag });
+        });
+        std::sort(variants.begin(), variants.end());
+
+        hasher.Update((uint64_t)variants.size());
+        for (auto& [name, tag] : variants) {
+            hasher.Update(name);
+            hasher.Update(tag);
+        }
+    } break;
+    default:
+        Panic("fingerprinting not implemented for type {}", (int)type->kind);
+    }
+}
+
+void InterfaceHasher::hashConst(ConstValue* value) {
+    hasher.Update((uint64_t)value->kind);
+
+    switch (value->kind) {
+    case CONST_I8:
+        hasher.Update((uint64_t)value->v_i8);
+        break;
+    case CONST_U8:
+        hasher.Update((uint64_t)value->v_u8);
+        break;
+    case CONST_I16:
+        hasher.Update((uint64_t)value->v_i16);
+        break;
+    case CONST_U16:
+        hasher.Update((uint64_t)value->v_u16);
+        break;
+    case CONST_I32:
+        hasher.Update((uint64_t)value->v_i32);
+        break;
+    case CONST_U32:
+        hasher.Update((uint64_t)value->v_u32);
+        break;
+    case CONST_I64:
+        hasher.Update((uint64_t)value->v_i64);
+        break;
+    case CONST_U64:
+        hasher.Update(value->v_u64);
+        break;
+    case CONST_F32: {
+        uint32_t bits;
+        memcpy(&bits, &value->v_f32, sizeof(bits));
+        hasher.Update((uint64_t)bits);
+    } break;
+    case CONST_F64: {
+        uint64_t bits;
+        memcpy(&bits, &value->v_f64, sizeof(bits));
+        hasher.Update(bits);
+    } break;
+    case CONST_BOOL:
+        hasher.Update((uint64_t)value->v_bool);
+        break;
+    case CONST_PTR:
+        hasher.Update(value->v_ptr);
+        break;
+    case CONST_FUNC:
+        hasher.Update((uint64_t)value->v_func->parent_id);
+        hasher.Update(value->v_func->name);
+        hashType(value->v_func->type);
+        break;
+    case CONST_ARRAY:
+        hashType(value->v_array.elem_type);
+        hasher.Update((uint64_t)value->v_array.elems.size());
+        for (auto* elem : value->v_array.elems) {
+            hashConst(elem);
+        }
+        break;
+    case CONST_ZERO_ARRAY:
+        hashType(value->v_zarr.elem_type);
+        hasher.Update(value->v_zarr.num_elems);
+        break;
+    case CONST_STRING:
+        hasher.Update(value->v_str.value);
+        break;
+    case CONST_STRUCT:
+        hasher.Update((uint64_t)value->v_struct.fields.size());
+        for (auto* field : value->v_struct.fields) {
+            hashConst(field);
+        }
+        break;
+    case CONST_ENUM:
+        hasher.Update(value->v_enum);
+        break;
+    default:
+        Panic("fingerprinting not implemented for constant {}", (int)value->kind);
+    }
+}
+
+void InterfaceHasher::hashAttrs(Decl* decl) {
+    hasher.Update((uint64_t)decl->attrs.size());
+    for (auto& attr : decl->attrs) {
+        hasher.Update(attr.name);
+        hasher.Update(attr.value);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::string FingerprintDecl(Module& mod, Decl* decl) {
+    InterfaceHasher ih;
+    ih.HashDecl(mod, decl);
+    return ih.Finish();
+}
+
+std::string FingerprintInterface(Module& mod) {
+    InterfaceHasher ih;
+
+    // Declarations that aren't part of the interface are not stored in module
+    // interface files, so they are left as nullptr in modules loaded from them.
+    for (auto* decl : mod.decls) {
+        if (decl == nullptr) {
+            continue;
+        }
+
+        switch (decl->hir_decl->kind) {
+        case HIR_METHOD:
+        case HIR_FACTORY:
+            ih.HashDecl(mod, decl);
+            break;
+        default:
+            if (decl->flags & DECL_EXPORTED) {
+                ih.HashDecl(mod, decl);
+            }
+            break;
+        }
+    }
+
+    return ih.Finish();
+}
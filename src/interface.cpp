@@ -0,0 +1,1082 @@
+#include "interface.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <random>
+#include <mutex>
+
+#include "sha256.hpp"
+
+namespace fs = std::filesystem;
+
+// The magic string is bumped whenever the format of interface files changes.
+#define INTERFACE_MAGIC "berry-bmi-1"
+
+// INTERFACE_MAX_DECLS is the largest number of declarations a module loaded
+// from an interface file can have.  Only the exported declarations are stored
+// in the file, so the declaration count can't be checked against its size.
+#define INTERFACE_MAX_DECLS ((uint64_t)1 << 24)
+
+/* -------------------------------------------------------------------------- */
+
+// InterfaceWriter encodes a checked module into an interface file.  All
+// integers are written as 64-bit little endian values, and all strings are
+// written as their length followed by their bytes.
+class InterfaceWriter {
+    std::string& buff;
+    Module& mod;
+
+public:
+    InterfaceWriter(std::string& buff, Module& mod)
+    : buff(buff)
+    , mod(mod)
+    {}
+
+    void WriteHeader(const InterfaceHeader& header);
+    void WriteBody();
+
+private:
+    void writeDeclHeader(Decl* decl, size_t decl_num);
+    void writeSymbol(Symbol* symbol);
+    void writeType(Type* type);
+    void writeConst(ConstValue* value);
+
+    void writeU64(uint64_t value);
+    void writeStr(std::string_view str);
+    void writeSpan(const TextSpan& span);
+};
+
+void InterfaceWriter::WriteHeader(const InterfaceHeader& header) {
+    writeStr(INTERFACE_MAGIC);
+    writeStr(header.config_key);
+    writeStr(header.source_hash);
+    writeU64(header.mod_id);
+    writeStr(header.fingerprint);
+    writeStr(header.obj_key);
+
+    writeU64(header.deps.size());
+    for (auto& dep : header.deps) {
+        writeU64(dep.mod_path.size());
+        for (auto& path_elem : dep.mod_path) {
+            writeStr(path_elem);
+        }
+
+        writeU64(dep.mod_id);
+        writeStr(dep.fingerprint);
+    }
+}
+
+// isInterfaceDecl returns whether decl is stored in its module's interface.
+// Type definitions are always stored since exported declarations can refer
+// to unexported types, and methods and factories are always stored since they
+// are added to the method tables of their bind types.
+static bool isInterfaceDecl(Decl* decl) {
+    switch (decl->hir_decl->kind) {
+    case HIR_STRUCT: case HIR_ALIAS: case HIR_ENUM:
+    case HIR_METHOD: case HIR_FACTORY:
+        return true;
+    default:
+        return decl->flags & DECL_EXPORTED;
+    }
+}
+
+void InterfaceWriter::WriteBody() {
+    writeU64(mod.decls.size());
+
+    // The type definitions are written first so that all the module's named
+    // types can be created before any type refers to them.
+    std::vector<size_t> typedef_nums, other_nums;
+    for (size_t i = 0; i < mod.decls.size(); i++) {
+        auto* decl = mod.decls[i];
+        if (!isInterfaceDecl(decl)) {
+            continue;
+        }
+
+        switch (decl->hir_decl->kind) {
+        case HIR_STRUCT: case HIR_ALIAS: case HIR_ENUM:
+            typedef_nums.push_back(i);
+            break;
+        default:
+            other_nums.push_back(i);
+            break;
+        }
+    }
+
+    writeU64(typedef_nums.size());
+    for (auto decl_num : typedef_nums) {
+        auto* decl = mod.decls[decl_num];
+        writeDeclHeader(decl, decl_num);
+
+        auto* symbol = decl->hir_decl->ir_TypeDef.symbol;
+        writeSymbol(symbol);
+        writeU64(symbol->type->kind);
+    }
+
+    for (auto decl_num : typedef_nums) {
+        writeType(mod.decls[decl_num]->hir_decl->ir_TypeDef.symbol->type->ty_Named.type);
+    }
+
+    writeU64(other_nums.size());
+    for (auto decl_num : other_nums) {
+        auto* decl = mod.decls[decl_num];
+        auto* hdecl = decl->hir_decl;
+        writeDeclHeader(decl, decl_num);
+
+        switch (hdecl->kind) {
+        case HIR_FUNC:
+            writeSymbol(hdecl->ir_Func.symbol);
+            writeType(hdecl->ir_Func.symbol->type);
+            break;
+        case HIR_GLOBAL_VAR:
+            writeSymbol(hdecl->ir_GlobalVar.symbol);
+            writeType(hdecl->ir_GlobalVar.symbol->type);
+            break;
+        case HIR_GLOBAL_CONST:
+            writeSymbol(hdecl->ir_GlobalConst.symbol);
+            writeType(hdecl->ir_GlobalConst.symbol->type);
+            writeConst(hdecl->ir_GlobalConst.init);
+            break;
+        case HIR_METHOD:
+            writeType(hdecl->ir_Method.bind_type);
+            writeStr(hdecl->ir_Method.method->name);
+            writeType(hdecl->ir_Method.method->signature);
+            writeU64(hdecl->ir_Method.method->exported);
+            break;
+        case HIR_FACTORY:
+            writeType(hdecl->ir_Factory.bind_type);
+            writeType(hdecl->ir_Factory.func->signature);
+            writeU64(hdecl->ir_Factory.func->exported);
+            break;
+        default:
+            Panic("interface writing not implemented for {}", (int)hdecl->kind);
+        }
+    }
+}
+
+void InterfaceWriter::writeDeclHeader(Decl* decl, size_t decl_num) {
+    writeU64(decl_num);
+    writeU64(decl->hir_decl->kind);
+    writeU64(decl->file_num);
+    writeU64(decl->flags);
+    writeSpan(decl->hir_decl->span);
+
+    writeU64(decl->attrs.size());
+    for (auto& attr : decl->attrs) {
+        writeStr(attr.name);
+        writeSpan(attr.name_span);
+        writeStr(attr.value);
+        writeSpan(attr.value_span);
+    }
+}
+
+void InterfaceWriter::writeSymbol(Symbol* symbol) {
+    writeStr(symbol->name);
+    writeSpan(symbol->span);
+    writeU64(symbol->flags);
+    writeU64(symbol->immut);
+}
+
+void InterfaceWriter::writeType(Type* type) {
+    if (type->kind == TYPE_UNTYP) {
+        Assert(type->ty_Untyp.concrete_type != nullptr, "writing uninferred untyped to interface");
+        type = type->ty_Untyp.concrete_type;
+    }
+
+    writeU64(type->kind);
+
+    switch (type->kind) {
+    case TYPE_INT:
+        writeU64(type->ty_Int.bit_size);
+        writeU64(type->ty_Int.is_signed);
+        break;
+    case TYPE_FLOAT:
+        writeU64(type->ty_Float.bit_size);
+        break;
+    case TYPE_BOOL:
+    case TYPE_UNIT:
+    case TYPE_STRING:
+        break;
+    case TYPE_PTR:
+        writeType(type->ty_Ptr.elem_type);
+        break;
+    case TYPE_FUNC:
+        writeU64(type->ty_Func.param_types.size());
+        for (auto* param_type : type->ty_Func.param_types) {
+            writeType(param_type);
+        }
+
+        writeType(type->ty_Func.return_type);
+        break;
+    case TYPE_ARRAY:
+        writeU64(type->ty_Array.len);
+        writeType(type->ty_Array.elem_type);
+        break;
+    case TYPE_SLICE:
+        writeType(type->ty_Slice.elem_type);
+        break;
+    case TYPE_NAMED:
+    case TYPE_ALIAS:
+        // Named types are stored by reference: they are defined by the type
+        // definitions of their modules.
+        writeU64(type->ty_Named.mod_id);
+        writeStr(type->ty_Named.name);
+        break;
+    case TYPE_STRUCT:
+        writeU64(type->ty_Struct.fields.size());
+        for (auto& field : type->ty_Struct.fields) {
+            writeStr(field.name);
+            writeU64(field.exported);
+            writeType(field.type);
+        }
+        break;
+    case TYPE_ENUM:
+        writeU64(type->ty_Enum.tag_map.size());
+        type->ty_Enum.tag_map.for_each([&](std::string_view name, uint64_t tag) {
+            writeStr(name);
+            writeU64(tag);
+        });
+        break;
+    default:
+        Panic("interface writing not implemented for type {}", (int)type->kind);
+    }
+}
+
+void InterfaceWriter::writeConst(ConstValue* value) {
+    writeU64(value->kind);
+
+    // Constant values are only allocated large enough to hold their variant, so
+    // each scalar has to be read as its own type.
+    switch (value->kind) {
+    case CONST_I8:
+        writeU64((uint64_t)value->v_i8);
+        break;
+    case CONST_U8:
+        writeU64(value->v_u8);
+        break;
+    case CONST_I16:
+        writeU64((uint64_t)value->v_i16);
+        break;
+    case CONST_U16:
+        writeU64(value->v_u16);
+        break;
+    case CONST_I32:
+        writeU64((uint64_t)value->v_i32);
+        break;
+    case CONST_U32:
+        writeU64(value->v_u32);
+        break;
+    case CONST_I64:
+        writeU64((uint64_t)value->v_i64);
+        break;
+    case CONST_U64:
+        writeU64(value->v_u64);
+        break;
+    case CONST_F32: {
+        uint32_t bits;
+        memcpy(&bits, &value->v_f32, sizeof(bits));
+        writeU64(bits);
+    } break;
+    case CONST_F64: {
+        uint64_t bits;
+        memcpy(&bits, &value->v_f64, sizeof(bits));
+        writeU64(bits);
+    } break;
+    case CONST_BOOL:
+        writeU64(value->v_bool);
+        break;
+    case CONST_PTR:
+        writeU64(value->v_ptr);
+        break;
+    case CONST_ENUM:
+        writeU64(value->v_enum);
+        break;
+    case CONST_FUNC:
+        writeU64(value->v_func->parent_id);
+        writeStr(value->v_func->name);
+        break;
+    case CONST_ARRAY:
+        writeType(value->v_array.elem_type);
+        writeU64(value->v_array.elems.size());
+        for (auto* elem : value->v_array.elems) {
+            writeConst(elem);
+        }
+        break;
+    case CONST_ZERO_ARRAY:
+        writeType(value->v_zarr.elem_type);
+        writeU64(value->v_zarr.num_elems);
+        break;
+    case CONST_STRING:
+        writeStr(value->v_str.value);
+        break;
+    case CONST_STRUCT:
+        writeU64(value->v_struct.fields.size());
+        for (auto* field : value->v_struct.fields) {
+            writeConst(field);
+        }
+        break;
+    default:
+        Panic("interface writing not implemented for constant {}", (int)value->kind);
+    }
+}
+
+void InterfaceWriter::writeU64(uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        buff.push_back((char)(value >> (i * 8)));
+    }
+}
+
+void InterfaceWriter::writeStr(std::string_view str) {
+    writeU64(str.size());
+    buff.append(str);
+}
+
+void InterfaceWriter::writeSpan(const TextSpan& span) {
+    writeU64(span.start_line);
+    writeU64(span.start_col);
+    writeU64(span.end_line);
+    writeU64(span.end_col);
+}
+
+bool WriteInterface(const std::string& path, Module& mod, const InterfaceHeader& header) {
+    std::string buff;
+    InterfaceWriter writer(buff, mod);
+    writer.WriteHeader(header);
+    writer.WriteBody();
+
+    // The interface is written to a temporary file and then renamed into
+    // place so that a partially written interface is never read.
+    auto temp_path = std::format("{}.{:x}.tmp", path, std::random_device{}());
+    {
+        std::ofstream file(temp_path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+
+        file.write(buff.data(), buff.size());
+        if (!file) {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(temp_path, path, ec);
+    if (ec) {
+        fs::remove(temp_path, ec);
+        return false;
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// BadInterface is thrown when an interface file is malformed.
+struct BadInterface {};
+
+// InterfaceReader decodes an interface file into a module.  Nothing is added
+// to the module (or to the method tables of other modules) until the whole
+// interface has been decoded so that a bad interface leaves them unchanged.
+class InterfaceReader {
+    std::string_view buff;
+    size_t pos;
+
+    Module* mod { nullptr };
+    Arena* arena { nullptr };
+    const std::vector<Module*>* mods_by_id { nullptr };
+
+    // local_types stores the named types defined by the module.
+    std::unordered_map<std::string_view, Type*> local_types;
+
+    // symbols stores the global symbols of the module.
+    std::vector<Symbol*> symbols;
+
+    // PendingFunc is a function constant whose symbol has not been resolved.
+    struct PendingFunc {
+        ConstValue* value;
+        size_t mod_id;
+        std::string_view name;
+    };
+    std::vector<PendingFunc> pending_funcs;
+
+    std::vector<std::pair<Type*, Method*>> method_bindings;
+    std::vector<std::pair<Type*, FactoryFunc*>> factory_bindings;
+
+public:
+    InterfaceReader(std::string_view buff, size_t pos)
+    : buff(buff)
+    , pos(pos)
+    {}
+
+    inline size_t GetPos() const { return pos; }
+
+    void ReadHeader(InterfaceHeader& header);
+    void ReadBody(Module& mod, Arena& arena, const std::vector<Module*>& mods_by_id);
+
+private:
+    Decl* readDeclHeader(size_t& decl_num);
+    Symbol* readSymbol(size_t decl_num);
+    Type* readType();
+    Type* readFuncType();
+    Type* lookupNamedType(size_t mod_id, std::string_view name);
+    ConstValue* readConst();
+
+    MethodTable& getMethodTable(Type* bind_type);
+
+    uint64_t readU64();
+    uint64_t readCount();
+    std::string_view readStr();
+    std::string_view readPersistentStr();
+    std::string_view readName();
+    TextSpan readSpan();
+};
+
+void InterfaceReader::ReadHeader(InterfaceHeader& header) {
+    if (readStr() != INTERFACE_MAGIC) {
+        throw BadInterface{};
+    }
+
+    header.config_key = readStr();
+    header.source_hash = readStr();
+    header.mod_id = readU64();
+    header.fingerprint = readStr();
+    header.obj_key = readStr();
+
+    auto n_deps = readCount();
+    header.deps.clear();
+    for (uint64_t i = 0; i < n_deps; i++) {
+        auto& dep = header.deps.emplace_back();
+
+        auto n_path_elems = readCount();
+        for (uint64_t j = 0; j < n_path_elems; j++) {
+            dep.mod_path.emplace_back(readStr());
+        }
+
+        dep.mod_id = readU64();
+        dep.fingerprint = readStr();
+    }
+}
+
+void InterfaceReader::ReadBody(Module& mod_, Arena& arena_, const std::vector<Module*>& mods_by_id_) {
+    mod = &mod_;
+    arena = &arena_;
+    mods_by_id = &mods_by_id_;
+
+    auto n_total_decls = readU64();
+    if (n_total_decls > INTERFACE_MAX_DECLS) {
+        throw BadInterface{};
+    }
+
+    std::vector<Decl*> decls(n_total_decls, nullptr);
+
+    // Create all the named types before reading any type.
+    std::vector<Type*> named_types;
+    auto n_typedefs = readCount();
+    for (uint64_t i = 0; i < n_typedefs; i++) {
+        size_t decl_num;
+        auto* decl = readDeclHeader(decl_num);
+        if (decl_num >= decls.size() || decls[decl_num] != nullptr) {
+            throw BadInterface{};
+        }
+
+        switch (decl->hir_decl->kind) {
+        case HIR_STRUCT: case HIR_ALIAS: case HIR_ENUM:
+            break;
+        default:
+            throw BadInterface{};
+        }
+
+        auto* symbol = readSymbol(decl_num);
+        auto kind = (TypeKind)readU64();
+        if (kind != TYPE_NAMED && kind != TYPE_ALIAS) {
+            throw BadInterface{};
+        }
+
+        auto* named_type = AllocType(*arena, kind);
+        named_type->ty_Named.mod_id = mod->id;
+        named_type->ty_Named.mod_name = mod->name;
+        named_type->ty_Named.name = symbol->name;
+        named_type->ty_Named.type = nullptr;
+        named_type->ty_Named.methods = nullptr;
+        named_type->ty_Named.factory = nullptr;
+        symbol->type = named_type;
+
+        decl->hir_decl->ir_TypeDef.symbol = symbol;
+        decls[decl_num] = decl;
+
+        local_types[symbol->name] = named_type;
+        named_types.push_back(named_type);
+    }
+
+    for (auto* named_type : named_types) {
+        named_type->ty_Named.type = readType();
+    }
+
+    auto n_decls = readCount();
+    for (uint64_t i = 0; i < n_decls; i++) {
+        size_t decl_num;
+        auto* decl = readDeclHeader(decl_num);
+        if (decl_num >= decls.size() || decls[decl_num] != nullptr) {
+            throw BadInterface{};
+        }
+
+        auto* hdecl = decl->hir_decl;
+
+        switch (hdecl->kind) {
+        case HIR_FUNC:
+            hdecl->ir_Func.symbol = readSymbol(decl_num);
+            hdecl->ir_Func.symbol->type = readFuncType();
+            hdecl->ir_Func.return_type = hdecl->ir_Func.symbol->type->ty_Func.return_type;
+            break;
+        case HIR_GLOBAL_VAR:
+            hdecl->ir_GlobalVar.symbol = readSymbol(decl_num);
+            hdecl->ir_GlobalVar.symbol->type = readType();
+            break;
+        case HIR_GLOBAL_CONST:
+            hdecl->ir_GlobalConst.symbol = readSymbol(decl_num);
+            hdecl->ir_GlobalConst.symbol->type = readType();
+            hdecl->ir_GlobalConst.init = readConst();
+            break;
+        case HIR_METHOD: {
+            auto* bind_type = readType();
+            if (bind_type->kind != TYPE_NAMED && bind_type->kind != TYPE_ALIAS) {
+                throw BadInterface{};
+            }
+
+            auto name = readName();
+            auto* signature = readFuncType();
+            auto* method = arena->New<Method>(mod->id, name, signature, (bool)readU64());
+            method->decl_num = decl_num;
+
+            hdecl->ir_Method.bind_type = bind_type;
+            hdecl->ir_Method.method = method;
+            hdecl->ir_Method.return_type = signature->ty_Func.return_type;
+            method_bindings.push_back({ bind_type, method });
+        } break;
+        case HIR_FACTORY: {
+            auto* bind_type = readType();
+            if (bind_type->kind != TYPE_NAMED && bind_type->kind != TYPE_ALIAS) {
+                throw BadInterface{};
+            }
+
+            auto* signature = readFuncType();
+            auto* factory = arena->New<FactoryFunc>(mod->id, signature, (bool)readU64());
+            factory->decl_num = decl_num;
+
+            hdecl->ir_Factory.bind_type = bind_type;
+            hdecl->ir_Factory.func = factory;
+            hdecl->ir_Factory.return_type = signature->ty_Func.return_type;
+            factory_bindings.push_back({ bind_type, factory });
+        } break;
+        default:
+            throw BadInterface{};
+        }
+
+        decls[decl_num] = decl;
+    }
+
+    if (pos != buff.size()) {
+        throw BadInterface{};
+    }
+
+    // Resolve function constants now that all the symbols are known.
+    std::unordered_map<std::string_view, Symbol*> local_symbols;
+    for (auto* symbol : symbols) {
+        local_symbols[symbol->name] = symbol;
+    }
+
+    for (auto& pending : pending_funcs) {
+        Symbol* symbol = nullptr;
+        if (pending.mod_id == mod->id) {
+            auto it = local_symbols.find(pending.name);
+            symbol = it == local_symbols.end() ? nullptr : it->second;
+        } else if (pending.mod_id < mods_by_id->size() && (*mods_by_id)[pending.mod_id] != nullptr) {
+            auto& symbol_table = (*mods_by_id)[pending.mod_id]->symbol_table;
+            auto it = symbol_table.find(pending.name);
+            symbol = it == symbol_table.end() ? nullptr : it->second;
+        }
+
+        if (symbol == nullptr || (symbol->flags & SYM_FUNC) == 0) {
+            throw BadInterface{};
+        }
+
+        pending.value->v_func = symbol;
+    }
+
+    // Bindings to types of other modules must not already exist: the checker
+    // would have reported a conflict when they were first merged.
+    for (auto& [bind_type, method] : method_bindings) {
+        auto* methods = bind_type->ty_Named.methods;
+        if (methods != nullptr && methods->contains(method->name)) {
+            throw BadInterface{};
+        }
+    }
+
+    for (auto& [bind_type, factory] : factory_bindings) {
+        if (bind_type->ty_Named.factory != nullptr) {
+            throw BadInterface{};
+        }
+    }
+
+    // Everything was decoded successfully: add it all to the module.
+    for (auto* symbol : symbols) {
+        mod->symbol_table.emplace(symbol->name, symbol);
+    }
+
+    for (auto& [bind_type, method] : method_bindings) {
+        getMethodTable(bind_type).emplace(method->name, method);
+    }
+
+    for (auto& [bind_type, factory] : factory_bindings) {
+        bind_type->ty_Named.factory = factory;
+    }
+
+    mod->decls = std::move(decls);
+}
+
+Decl* InterfaceReader::readDeclHeader(size_t& decl_num) {
+    decl_num = readU64();
+    auto kind = (HirKind)readU64();
+    auto file_num = readU64();
+    auto flags = (DeclFlags)readU64();
+    auto span = readSpan();
+
+    if (file_num >= mod->files.size()) {
+        throw BadInterface{};
+    }
+
+    std::vector<Attribute> attrs;
+    auto n_attrs = readCount();
+    for (uint64_t i = 0; i < n_attrs; i++) {
+        auto& attr = attrs.emplace_back();
+        attr.name = readName();
+        attr.name_span = readSpan();
+        attr.value = readPersistentStr();
+        attr.value_span = readSpan();
+    }
+
+    auto* decl = arena->New<Decl>(file_num, flags, arena->MoveVec(std::move(attrs)), nullptr);
+
+    if (kind >= HIR_BLOCK) {
+        throw BadInterface{};
+    }
+
+    auto* hdecl = (HirDecl*)arena->Alloc(sizeof(HirDecl));
+    hdecl->kind = kind;
+    hdecl->span = span;
+    decl->hir_decl = hdecl;
+
+    switch (kind) {
+    case HIR_FUNC:
+        hdecl->ir_Func.params = {};
+        hdecl->ir_Func.body = nullptr;
+        break;
+    case HIR_GLOBAL_VAR:
+        hdecl->ir_GlobalVar.init = nullptr;
+        hdecl->ir_GlobalVar.const_init = nullptr;
+        break;
+    case HIR_METHOD:
+        hdecl->ir_Method.self_ptr = nullptr;
+        hdecl->ir_Method.params = {};
+        hdecl->ir_Method.body = nullptr;
+        break;
+    case HIR_FACTORY:
+        hdecl->ir_Factory.params = {};
+        hdecl->ir_Factory.body = nullptr;
+        break;
+    default:
+        break;
+    }
+
+    return decl;
+}
+
+Symbol* InterfaceReader::readSymbol(size_t decl_num) {
+    auto name = readName();
+    auto span = readSpan();
+    auto flags = (SymbolFlags)readU64();
+    bool immut = readU64();
+
+    auto* symbol = arena->New<Symbol>(mod->id, name, span, flags, decl_num, nullptr, immut);
+    symbols.push_back(symbol);
+    return symbol;
+}
+
+Type* InterfaceReader::readType() {
+    auto kind = (TypeKind)readU64();
+
+    switch (kind) {
+    case TYPE_INT: {
+        auto bit_size = readU64();
+        bool is_signed = readU64();
+
+        switch (bit_size) {
+        case 8: return is_signed ? &prim_i8_type : &prim_u8_type;
+        case 16: return is_signed ? &prim_i16_type : &prim_u16_type;
+        case 32: return is_signed ? &prim_i32_type : &prim_u32_type;
+        case 64: return is_signed ? &prim_i64_type : &prim_u64_type;
+        }
+    } break;
+    case TYPE_FLOAT:
+        switch (readU64()) {
+        case 32: return &prim_f32_type;
+        case 64: return &prim_f64_type;
+        }
+        break;
+    case TYPE_BOOL:
+        return &prim_bool_type;
+    case TYPE_UNIT:
+        return &prim_unit_type;
+    case TYPE_STRING:
+        return &prim_string_type;
+    case TYPE_PTR: {
+        auto* type = AllocType(*arena, TYPE_PTR);
+        type->ty_Ptr.elem_type = readType();
+        return type;
+    }
+    case TYPE_FUNC: {
+        std::vector<Type*> param_types(readCount());
+        for (auto& param_type : param_types) {
+            param_type = readType();
+        }
+
+        auto* type = AllocType(*arena, TYPE_FUNC);
+        type->ty_Func.param_types = arena->MoveVec(std::move(param_types));
+        type->ty_Func.return_type = readType();
+        return type;
+    }
+    case TYPE_ARRAY: {
+        auto* type = AllocType(*arena, TYPE_ARRAY);
+        type->ty_Array.len = readU64();
+        type->ty_Array.elem_type = readType();
+        return type;
+    }
+    case TYPE_SLICE: {
+        auto* type = AllocType(*arena, TYPE_SLICE);
+        type->ty_Slice.elem_type = readType();
+        return type;
+    }
+    case TYPE_NAMED:
+    case TYPE_ALIAS: {
+        auto mod_id = readU64();
+        auto name = readStr();
+
+        auto* type = lookupNamedType(mod_id, name);
+        if (type->kind != kind) {
+            throw BadInterface{};
+        }
+
+        return type;
+    }
+    case TYPE_STRUCT: {
+        std::vector<StructField> fields;
+        NameMap<size_t> name_map;
+
+        auto n_fields = readCount();
+        for (uint64_t i = 0; i < n_fields; i++) {
+            auto name = readName();
+            bool exported = readU64();
+            auto* field_type = readType();
+
+            fields.emplace_back(name, field_type, exported);
+            name_map.emplace(name, i);
+        }
+
+        auto* type = AllocType(*arena, TYPE_STRUCT);
+        type->ty_Struct.fields = arena->MoveVec(std::move(fields));
+        type->ty_Struct.name_map = MapView(*arena, std::move(name_map));
+        return type;
+    }
+    case TYPE_ENUM: {
+        NameMap<uint64_t> tag_map;
+
+        auto n_variants = readCount();
+        for (uint64_t i = 0; i < n_variants; i++) {
+            auto name = readName();
+            tag_map.emplace(name, readU64());
+        }
+
+        auto* type = AllocType(*arena, TYPE_ENUM);
+        type->ty_Enum.tag_map = MapView(*arena, std::move(tag_map));
+        return type;
+    }
+    }
+
+    throw BadInterface{};
+}
+
+// readFuncType reads a type which must be a function type: that is the type of
+// a function or the signature of a method or factory.
+Type* InterfaceReader::readFuncType() {
+    auto* type = readType();
+    if (type->kind != TYPE_FUNC) {
+        throw BadInterface{};
+    }
+
+    return type;
+}
+
+Type* InterfaceReader::lookupNamedType(size_t mod_id, std::string_view name) {
+    if (mod_id == mod->id) {
+        auto it = local_types.find(name);
+        if (it != local_types.end()) {
+            return it->second;
+        }
+    } else if (mod_id < mods_by_id->size() && (*mods_by_id)[mod_id] != nullptr) {
+        auto& symbol_table = (*mods_by_id)[mod_id]->symbol_table;
+
+        auto it = symbol_table.find(name);
+        if (it != symbol_table.end() && (it->second->flags & SYM_TYPE)) {
+            return it->second->type;
+        }
+    }
+
+    throw BadInterface{};
+}
+
+ConstValue* InterfaceReader::readConst() {
+    auto* value = (ConstValue*)arena->Alloc(sizeof(ConstValue));
+    value->kind = (ConstKind)readU64();
+
+    switch (value->kind) {
+    case CONST_I8:
+        value->v_i8 = (int8_t)readU64();
+        break;
+    case CONST_U8:
+        value->v_u8 = (uint8_t)readU64();
+        break;
+    case CONST_I16:
+        value->v_i16 = (int16_t)readU64();
+        break;
+    case CONST_U16:
+        value->v_u16 = (uint16_t)readU64();
+        break;
+    case CONST_I32:
+        value->v_i32 = (int32_t)readU64();
+        break;
+    case CONST_U32:
+        value->v_u32 = (uint32_t)readU64();
+        break;
+    case CONST_I64:
+        value->v_i64 = (int64_t)readU64();
+        break;
+    case CONST_U64:
+        value->v_u64 = readU64();
+        break;
+    case CONST_F32: {
+        uint32_t bits = (uint32_t)readU64();
+        memcpy(&value->v_f32, &bits, sizeof(bits));
+    } break;
+    case CONST_F64: {
+        uint64_t bits = readU64();
+        memcpy(&value->v_f64, &bits, sizeof(bits));
+    } break;
+    case CONST_BOOL:
+        value->v_bool = readU64();
+        break;
+    case CONST_PTR:
+        value->v_ptr = readU64();
+        break;
+    case CONST_ENUM:
+        value->v_enum = readU64();
+        break;
+    case CONST_FUNC: {
+        auto mod_id = readU64();
+        auto name = readStr();
+
+        value->v_func = nullptr;
+        pending_funcs.push_back({ value, mod_id, name });
+    } break;
+    case CONST_ARRAY: {
+        value->v_array.elem_type = readType();
+
+        std::vector<ConstValue*> elems(readCount());
+        for (auto& elem : elems) {
+            elem = readConst();
+        }
+
+        value->v_array.elems = arena->MoveVec(std::move(elems));
+    } break;
+    case CONST_ZERO_ARRAY:
+        value->v_zarr.elem_type = readType();
+        value->v_zarr.num_elems = readU64();
+        break;
+    case CONST_STRING:
+        value->v_str.value = readPersistentStr();
+        break;
+    case CONST_STRUCT: {
+        std::vector<ConstValue*> fields(readCount());
+        for (auto& field : fields) {
+            field = readConst();
+        }
+
+        value->v_struct.fields = arena->MoveVec(std::move(fields));
+    } break;
+    default:
+        throw BadInterface{};
+    }
+
+    return value;
+}
+
+MethodTable& InterfaceReader::getMethodTable(Type* bind_type) {
+    if (bind_type->ty_Named.methods == nullptr) {
+        // The method table is owned by the module which defines the type.
+        auto* owner_mod = (*mods_by_id)[bind_type->ty_Named.mod_id];
+
+        auto mnode = std::make_unique<Module::MtableNode>();
+        bind_type->ty_Named.methods = &mnode->mtable;
+
+        mnode->next = std::move(owner_mod->mtable_list);
+        owner_mod->mtable_list = std::move(mnode);
+    }
+
+    return *bind_type->ty_Named.methods;
+}
+
+uint64_t InterfaceReader::readU64() {
+    if (buff.size() - pos < 8) {
+        throw BadInterface{};
+    }
+
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= (uint64_t)(uint8_t)buff[pos++] << (i * 8);
+    }
+
+    return value;
+}
+
+uint64_t InterfaceReader::readCount() {
+    // Every item of a list takes at least 8 bytes, so a count which doesn't
+    // fit in the rest of the file is rejected before anything is allocated for
+    // its items.
+    auto count = readU64();
+    if (count > (buff.size() - pos) / 8) {
+        throw BadInterface{};
+    }
+
+    return count;
+}
+
+std::string_view InterfaceReader::readStr() {
+    auto len = readU64();
+    if (buff.size() - pos < len) {
+        throw BadInterface{};
+    }
+
+    auto str = buff.substr(pos, len);
+    pos += len;
+    return str;
+}
+
+std::string_view InterfaceReader::readPersistentStr() {
+    // The strings are used in place: the interface file stays mapped for as
+    // long as the module is in use.
+    return readStr();
+}
+
+std::string_view InterfaceReader::readName() {
+    // Names are interned like the names of modules loaded from source so that
+    // lookups of them are just as fast.
+    return InternName(readStr());
+}
+
+TextSpan InterfaceReader::readSpan() {
+    TextSpan span;
+    span.start_line = readU64();
+    span.start_col = readU64();
+    span.end_line = readU64();
+    span.end_col = readU64();
+    return span;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool InterfaceFile::Open(const std::string& path) {
+    if (!file.Open(path)) {
+        return false;
+    }
+
+    try {
+        InterfaceReader reader(file.View(), 0);
+        reader.ReadHeader(header);
+        body_start = reader.GetPos();
+    } catch (BadInterface&) {
+        return false;
+    }
+
+    return true;
+}
+
+bool InterfaceFile::Load(Module& mod, Arena& arena, const std::vector<Module*>& mods_by_id) {
+    try {
+        InterfaceReader reader(file.View(), body_start);
+        reader.ReadBody(mod, arena, mods_by_id);
+    } catch (BadInterface&) {
+        return false;
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// OpenInterfaceEntry is an interface file which has been opened along with the
+// state of the file on disk when it was opened.
+struct OpenInterfaceEntry {
+    fs::file_time_type mod_time;
+    uintmax_t size;
+    std::shared_ptr<InterfaceFile> file;
+};
+
+static std::mutex open_interfaces_mutex;
+static std::unordered_map<std::string, OpenInterfaceEntry> open_interfaces;
+
+std::shared_ptr<InterfaceFile> OpenInterfaceFile(const std::string& path) {
+    std::error_code ec;
+    auto mod_time = fs::last_write_time(path, ec);
+    if (ec) {
+        return nullptr;
+    }
+
+    auto size = fs::file_size(path, ec);
+    if (ec) {
+        return nullptr;
+    }
+
+    std::unique_lock<std::mutex> lock(open_interfaces_mutex);
+
+    auto it = open_interfaces.find(path);
+    if (it != open_interfaces.end() && it->second.mod_time == mod_time && it->second.size == size) {
+        return it->second.file;
+    }
+
+    // Interface files are replaced rather than modified in place, so modules
+    // still using an old mapping are unaffected when it is dropped here.
+    auto file = std::make_shared<InterfaceFile>();
+    if (!file->Open(path)) {
+        return nullptr;
+    }
+
+    open_interfaces[path] = { mod_time, size, file };
+    return file;
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::string GetInterfaceKey(Module& mod) {
+    Sha256 hasher;
+    for (auto& src_file : mod.files) {
+        hasher.Update(src_file.abs_path);
+    }
+
+    return hasher.HexDigest();
+}
+
+void HashSourceFile(Sha256& hasher, const SourceFile& src_file, std::string_view src) {
+    // Both paths end up in diagnostics and debug info.
+    hasher.Update(src_file.abs_path);
+    hasher.Update(src_file.display_path);
+    hasher.Update(src);
+}
@@ -0,0 +1,96 @@
+#include "interner.hpp"
+
+#include <unordered_set>
+
+// INTERN_SHARDS is the number of independently locked shards of the intern
+// table: names are interned by all the parse workers at once.
+#define INTERN_SHARDS 64
+
+// name_arena stores the interned names.  Each name is preceded by its
+// InternedHeader and followed by a null terminator.
+static Arena name_arena { ARENA_GLOBAL, true };
+
+// InternedHeader is stored before each interned name.  The length lets views
+// which only point into an interned name (eg. substrings of it) be told apart
+// from the name itself.
+struct InternedHeader {
+    uint64_t hash;
+    size_t len;
+};
+
+// InternShard is one shard of the intern table.  Names are assigned to shards
+// by their hash.
+struct InternShard {
+    std::mutex mutex;
+    std::unordered_set<std::string_view, NameHash, NameEq> names;
+};
+
+static InternShard intern_shards[INTERN_SHARDS];
+
+// hashBytes computes the FNV-1a hash of name.
+static uint64_t hashBytes(std::string_view name) {
+    uint64_t hash = 0xcbf29ce484222325;
+    for (char c : name) {
+        hash ^= (uint8_t)c;
+        hash *= 0x100000001b3;
+    }
+
+    return hash;
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::string_view InternName(std::string_view name) {
+    if (name.empty()) {
+        return {};
+    }
+
+    auto hash = hashBytes(name);
+    auto& shard = intern_shards[hash % INTERN_SHARDS];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.names.find(name);
+    if (it != shard.names.end()) {
+        return *it;
+    }
+
+    auto* header = (InternedHeader*)name_arena.Alloc(sizeof(InternedHeader) + name.size() + 1);
+    header->hash = hash;
+    header->len = name.size();
+
+    auto* data = (char*)(header + 1);
+    memcpy(data, name.data(), name.size());
+    data[name.size()] = '\0';
+
+    std::string_view interned { data, name.size() };
+    shard.names.insert(interned);
+    return interned;
+}
+
+bool IsInterned(std::string_view name) {
+    if (name.empty() || !name_arena.Contains(name.data())) {
+        return false;
+    }
+
+    // A view which merely points into the arena may not be preceded by a
+    // header at all, so the header is read bytewise in case it is unaligned.
+    // It is always safe to read: the arena's chunk header comes before it.
+    InternedHeader header;
+    memcpy(&header, name.data() - sizeof(InternedHeader), sizeof(InternedHeader));
+    return header.len == name.size() && name.data()[name.size()] == '\0';
+}
+
+uint64_t HashName(std::string_view name) {
+    if (IsInterned(name)) {
+        InternedHeader header;
+        memcpy(&header, name.data() - sizeof(InternedHeader), sizeof(InternedHeader));
+        return header.hash;
+    }
+
+    return hashBytes(name);
+}
+
+const Arena& GetNameArena() {
+    return name_arena;
+}
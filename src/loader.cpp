@@ -2,8 +2,12 @@
 
 #include <locale>
 #include <codecvt>
+#include <algorithm>
+#include <fstream>
 
 #include "parser.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
 
 #if OS_WINDOWS
     #define WIN32_LEAN_AND_MEAN 1
@@ -76,10 +80,12 @@ static std::string createDisplayPath(const fs::path& local_path, const fs::path&
 
 /* -------------------------------------------------------------------------- */
 
-Loader::Loader(Arena& global_arena, Arena& ast_arena, const std::vector<std::string>& import_paths_) 
+Loader::Loader(Arena& global_arena, const std::vector<std::string>& import_paths_, size_t n_workers) 
 : global_arena(global_arena)
-, ast_arena(ast_arena)
+, n_workers(n_workers)
 {
+    Assert(global_arena.IsConcurrent(), "loader arena must be concurrent");
+
     import_paths.reserve(import_paths_.size());
     for (auto& str_path : import_paths_) {
         import_paths.emplace_back(str_path);
@@ -102,18 +108,17 @@ void Loader::LoadAll(const std::string& root_mod) {
     }
 
     loadRootModule(root_path);
+    finishLoading(core_mod);
+}
 
-    while (load_queue.size() > 0) {
-        auto entry = load_queue.front();
-        load_queue.pop();
+void Loader::LoadStd() {
+    finishLoading(loadDefaults());
+}
 
-        auto it = mod_table.find(entry.mod_path.string());
-        if (it != mod_table.end()) {
-            entry.dep.mod = &it->second;
-        } else {
-            entry.dep.mod = &loadModule(entry.local_path, entry.mod_path);
-        }
-    }
+void Loader::finishLoading(Module& core_mod) {
+    loadWaves();
+
+    Assert(core_mod.deps.size() == 0, "core module must have no dependencies");
 
     for (auto& mod : *this) {
         if (mod.id != core_mod.id) {
@@ -122,6 +127,24 @@ void Loader::LoadAll(const std::string& root_mod) {
     }
 
     checkForImportCycles();
+
+    if (interfaces.size() > 0) {
+        loadInterfaces(core_mod);
+    }
+}
+
+void Loader::EnableInterfaces(const BuildCache* cache, const std::string& config_key, const std::string& obj_ext) {
+    interfaces_enabled = true;
+    if (cache != nullptr) {
+        interface_caches.push_back(cache);
+    }
+
+    interface_config_key = config_key;
+    interface_obj_ext = obj_ext;
+}
+
+std::string Loader::GetStdSnapshotDir() {
+    return (findBerryPath() / "snapshot").string();
 }
 
 std::vector<Module*>& Loader::SortModulesByDepGraph() {
@@ -129,7 +152,9 @@ std::vector<Module*>& Loader::SortModulesByDepGraph() {
         std::vector<bool> visited(mod_table.size(), false);
     
         sortModule(runtime_mod, visited);
-        sortModule(root_mod, visited);
+        if (root_mod != nullptr) {
+            sortModule(root_mod, visited);
+        }
     }
 
     return sorted_mods;
@@ -140,11 +165,20 @@ std::vector<Module*>& Loader::SortModulesByDepGraph() {
 Module& Loader::loadDefaults() {
     auto berry_path = findBerryPath();
 
+    // The snapshot of the standard library is created at install time by
+    // running the compiler with --snapshot-std.
+    std::error_code ec;
+    auto snapshot_dir = berry_path / "snapshot";
+    if (interfaces_enabled && fs::is_directory(snapshot_dir, ec)) {
+        std_snapshot = std::make_unique<BuildCache>(snapshot_dir.string());
+        std_snapshot->Open();
+        interface_caches.insert(interface_caches.begin(), std_snapshot.get());
+    }
+
     auto std_path = berry_path / "mods" / "std";
     import_paths.emplace_back(std_path);
 
     auto& core_mod = loadModule(std_path, std_path / "core");
-    Assert(core_mod.deps.size() == 0, "core module must have no dependencies");
 
     runtime_mod = &loadModule(std_path, std_path / "runtime");
     Assert(runtime_mod->id == BERRY_RT_MOD_ID, "runtime module must be second module loaded");
@@ -183,8 +217,7 @@ void Loader::loadRootModule(fs::path& root_mod_abs_path) {
             src_file.parent = &mod;
             mod.files.emplace_back(std::move(src_file));
 
-            parseModule(mod);
-            resolveImports(local_path, mod);
+            parse_wave.push_back({ local_path, &mod });
 
             root_mod = &mod;
         } else {
@@ -198,9 +231,9 @@ void Loader::loadRootModule(fs::path& root_mod_abs_path) {
 }
 
 Module& Loader::loadModule(const fs::path& local_path, const fs::path& mod_abs_path) {
+    // The module is parsed as part of the next wave.
     auto& mod = initModule(local_path, mod_abs_path);
-    parseModule(mod);
-    resolveImports(local_path, mod);
+    parse_wave.push_back({ local_path, &mod });
     return mod;
 }
 
@@ -247,20 +280,232 @@ Module& Loader::initModule(const fs::path& local_path, const fs::path& mod_abs_p
     return mod;
 }
 
+void Loader::loadWaves() {
+    while (parse_wave.size() > 0) {
+        parseWave();
+
+        while (load_queue.size() > 0) {
+            auto entry = load_queue.front();
+            load_queue.pop();
+
+            auto it = mod_table.find(entry.mod_path.string());
+            if (it != mod_table.end()) {
+                entry.dep.mod = &it->second;
+            } else {
+                entry.dep.mod = &loadModule(entry.local_path, entry.mod_path);
+            }
+        }
+    }
+}
+
+void Loader::parseWave() {
+    // Parsing only touches the module being parsed, so the modules of a wave
+    // can be parsed concurrently.  Each module's errors are buffered and then
+    // displayed in wave order along with any errors resolving its imports.
+    std::vector<DiagnosticBuffer> diag_buffs(parse_wave.size());
+    std::vector<std::shared_ptr<InterfaceFile>> wave_interfaces(parse_wave.size());
+    std::vector<const BuildCache*> wave_caches(parse_wave.size(), nullptr);
+
+    try {
+        ParallelFor(n_workers, parse_wave.size(), [&](size_t, size_t i) {
+            auto& mod = *parse_wave[i].mod;
+
+            // Modules with a usable interface file don't need to be parsed:
+            // their imports are stored in the interface file.
+            if (interfaces_enabled && &mod != root_mod) {
+                wave_caches[i] = openInterface(mod, wave_interfaces[i]);
+                if (wave_caches[i] != nullptr) {
+                    return;
+                }
+            }
+
+            CaptureDiagnostics capture(diag_buffs[i]);
+            parseModule(mod);
+        });
+    } catch (CompileError&) {
+        for (auto& diag_buff : diag_buffs) {
+            diag_buff.Flush();
+        }
+
+        throw;
+    }
+
+    // Resolving imports may add modules to the next wave.
+    auto curr_wave = std::move(parse_wave);
+    parse_wave.clear();
+
+    for (size_t i = 0; i < curr_wave.size(); i++) {
+        if (wave_interfaces[i]) {
+            interfaces.emplace(curr_wave[i].mod, InterfaceEntry{ curr_wave[i].local_path, wave_caches[i], std::move(wave_interfaces[i]) });
+        }
+
+        diag_buffs[i].Flush();
+        resolveImports(curr_wave[i].local_path, *curr_wave[i].mod);
+    }
+}
+
+// readSourceFile reads the whole source file at path into src.  Sources are
+// read into a buffer rather than mapped: a file which is truncated while it is
+// being lexed would make reads from a mapping fault and take down the compiler
+// (or the build server) with it.
+static bool readSourceFile(const std::string& path, std::string& src) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+
+    src.resize((size_t)file.tellg());
+    file.seekg(0);
+    file.read(src.data(), src.size());
+
+    // The file may have shrunk since its size was read.
+    src.resize((size_t)file.gcount());
+    return !file.bad();
+}
+
+// hashModuleSources reads the source files of mod and stores their hash in
+// mod.source_hash.  This returns false if any of them can't be read.
+static bool hashModuleSources(Module& mod) {
+    Sha256 hasher;
+    for (auto& src_file : mod.files) {
+        std::string src;
+        if (!readSourceFile(src_file.abs_path, src)) {
+            return false;
+        }
+
+        HashSourceFile(hasher, src_file, src);
+    }
+
+    mod.source_hash = hasher.HexDigest();
+    return true;
+}
+
 void Loader::parseModule(Module& mod) {
+    TraceScope trace_scope("Parse Module", mod.name);
+
+    // The sources are hashed as they are lexed: a file may change on disk
+    // before the module's object or interface is written.
+    Sha256 hasher;
     for (auto& src_file : mod.files) {
-        std::ifstream file(src_file.abs_path);
-        if (!file) {
-            ReportFatal("opening source file: {}", strerror(errno));
+        std::string src;
+        if (!readSourceFile(src_file.abs_path, src)) {
+            ReportFatal("opening source file: {}", src_file.abs_path);
         }
 
+        HashSourceFile(hasher, src_file, src);
+
         try {
-            Parser p(global_arena, ast_arena, file, src_file);
+            Parser p(global_arena, mod.ast_arena, src, src_file);
             p.ParseFile();
         } catch (CompileError&) {
             // Nothing to do, just stop error bubbling.
         }
     }
+
+    mod.source_hash = hasher.HexDigest();
+}
+
+const BuildCache* Loader::openInterface(Module& mod, std::shared_ptr<InterfaceFile>& itf) {
+    auto itf_key = GetInterfaceKey(mod);
+
+    std::shared_ptr<InterfaceFile> file;
+    const BuildCache* itf_cache = nullptr;
+    for (auto* cache : interface_caches) {
+        file = OpenInterfaceFile(cache->GetObjectPath(itf_key, BERRY_INTERFACE_EXT));
+        if (file && file->header.config_key == interface_config_key) {
+            itf_cache = cache;
+            break;
+        }
+    }
+
+    if (itf_cache == nullptr || !hashModuleSources(mod) || file->header.source_hash != mod.source_hash) {
+        return nullptr;
+    }
+
+    auto& header = file->header;
+    // The last dependency of every module other than the core module is the
+    // core module: it is added back once all the modules are loaded.
+    size_t n_deps = header.deps.size() > 0 ? header.deps.size() - 1 : 0;
+    for (size_t i = 0; i < n_deps; i++) {
+        mod.deps.emplace_back(i, std::vector<std::string>(header.deps[i].mod_path));
+    }
+
+    itf = std::move(file);
+    return itf_cache;
+}
+
+void Loader::loadInterfaces(Module& core_mod) {
+    TraceScope trace_scope("Load Interfaces");
+
+    std::vector<Module*> mods_by_id(mod_table.size(), nullptr);
+    for (auto& mod : *this) {
+        mods_by_id[mod.id] = &mod;
+    }
+
+    // Modules are loaded from their interfaces in dependency order since an
+    // interface can only be used if all the module's dependencies were loaded
+    // from unchanged interfaces.
+    std::vector<Module*> fallback_mods;
+    for (auto* mod : SortModulesByDepGraph()) {
+        auto it = interfaces.find(mod);
+        if (it == interfaces.end()) {
+            continue;
+        }
+
+        auto& entry = it->second;
+        auto& header = entry.file->header;
+        if (isInterfaceValid(*mod, *entry.cache, header) && entry.file->Load(*mod, global_arena, mods_by_id)) {
+            mod->from_interface = true;
+            mod->obj_key = header.obj_key;
+            mod->obj_path = entry.cache->GetObjectPath(header.obj_key, interface_obj_ext);
+            mod->fingerprint = header.fingerprint;
+
+            loaded_interfaces.push_back(std::move(entry.file));
+        } else {
+            fallback_mods.push_back(mod);
+        }
+    }
+
+    // The modules whose interfaces can't be used are loaded from source.
+    size_t n_prev_mods = mod_table.size();
+    interfaces_enabled = false;
+    for (auto* mod : fallback_mods) {
+        mod->deps.clear();
+        parse_wave.push_back({ interfaces[mod].local_path, mod });
+    }
+
+    interfaces.clear();
+    loadWaves();
+
+    for (auto& mod : *this) {
+        bool needs_core_dep = mod.id >= n_prev_mods || std::find(fallback_mods.begin(), fallback_mods.end(), &mod) != fallback_mods.end();
+        if (needs_core_dep && mod.id != core_mod.id) {
+            mod.deps.emplace_back(mod.deps.size(), &core_mod);
+        }
+    }
+
+    if (fallback_mods.size() > 0) {
+        sorted_mods.clear();
+        checkForImportCycles();
+    }
+}
+
+bool Loader::isInterfaceValid(Module& mod, const BuildCache& cache, const InterfaceHeader& header) {
+    // Module IDs appear in mangled names.
+    if (header.mod_id != mod.id || header.deps.size() != mod.deps.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < mod.deps.size(); i++) {
+        auto* dep_mod = mod.deps[i].mod;
+        auto& header_dep = header.deps[i];
+
+        if (!dep_mod->from_interface || dep_mod->id != header_dep.mod_id || dep_mod->fingerprint != header_dep.fingerprint) {
+            return false;
+        }
+    }
+
+    return cache.Contains(header.obj_key, interface_obj_ext);
 }
 
 void Loader::resolveImports(const fs::path& local_path, Module& mod) {
@@ -310,14 +555,16 @@ std::optional<fs::path> Loader::findModule(const fs::path& search_path, const st
     path.replace_extension(BERRY_FILE_EXT);
 
     if (fs::exists(path) && fs::is_regular_file(path)) {
-        std::ifstream file;
-        if (file) {
+        std::string src;
+        if (readSourceFile(path.string(), src)) {
             SourceFile src_file { nullptr, 0, path.string(), createDisplayPath(search_path, path)};
-            Parser p(global_arena, ast_arena, file, src_file);
+
+            // Only the module name is parsed: no AST is kept.
+            ScratchScope scratch;
+            Parser p(global_arena, scratch.Get(), src, src_file);
 
             auto mod_name_tok = p.ParseModuleName();
-            file.close();
-            
+
             if (mod_name_tok.value == "" || mod_name_tok.value == mod_path.back()) {
                 return path;
             }
@@ -428,14 +675,14 @@ Module& Loader::addModule(const fs::path& mod_abs_path, const std::string& mod_n
 
 std::string Loader::getModuleName(SourceFile& src_file) {
     try {
-        std::ifstream file(src_file.abs_path);
-        if (!file) {
-            ReportFatal("opening file: {}", strerror(errno));
+        std::string src;
+        if (!readSourceFile(src_file.abs_path, src)) {
+            ReportFatal("opening file: {}", src_file.abs_path);
         }
 
-        Parser p(global_arena, ast_arena, file, src_file);
+        ScratchScope scratch;
+        Parser p(global_arena, scratch.Get(), src, src_file);
         auto mod_tok = p.ParseModuleName();
-        file.close();
 
         auto trimmed_fname = fs::path(src_file.abs_path).filename().replace_extension().string();
         if (mod_tok.kind == TOK_EOF) {
@@ -453,7 +700,7 @@ std::string Loader::getModuleName(SourceFile& src_file) {
             }
         }
 
-        return mod_tok.value;
+        return std::string(mod_tok.value);
     } catch (CompileError& err) {
         return "";
     }
@@ -4,6 +4,7 @@
 #include <filesystem>
 
 #include "driver.hpp"
+#include "server.hpp"
 
 namespace fs = std::filesystem;
 
@@ -16,11 +17,18 @@ std::string usage_str =
     "    -v, --verbose   Print out compilation steps, list modules compiled\n"
     "    -V, --version   Print the compiler version and exit\n"
     "    -q, --quiet     Compile silently, no command line output\n"
+    "    -P, --parcheck  Check the function bodies of each module in parallel\n"
+    "    --nocache       Don't reuse or cache objects between builds\n"
+    "    --snapshot-std  Build the snapshot of the standard library and exit\n"
+    "    --stats         Print statistics about the compilation\n"
+    "    --mem-report    Print the memory used by the compiler after each phase\n"
+    "    --server        Run as a compile server: builds are forwarded to the\n"
+    "                    server when BERRY_SERVER is set to its socket path\n"
     "\n"
     "Arguments:\n"
     "    -o, --outpath   Specify the output path (default = out[.exe])\n"
     "    -E, --emit      Specify the output format\n"
-    "                    :: exe (default), static, shared, obj, asm, llvm, dumpast\n"
+    "                    :: exe (default), static, shared, obj, asm, llvm, check, dumpast\n"
     "    -g, --gendebug  Specify the debug format, automatically enables debug info\n"
     "                    :: native (default), dwarf, gdb (= dwarf), codeview, msvc (= codeview)\n"
     "    -L, --libpath   Specify additional linker include directories\n"
@@ -28,7 +36,12 @@ std::string usage_str =
     "    -W, --warn      Enable specific warnings\n"
     "    -w, --nowarn    Disable specific warnings\n"
     "    -O, --optlevel  Set optimization level (default = 1)\n"
-    "    -I, --import    Specify additional import path\n\n";
+    "                    :: 0, 1, 2, 3, s (optimize for size), z (minimize size)\n"
+    "    -I, --import    Specify additional import path\n"
+    "    -j, --jobs      Set the number of worker threads (default = hardware threads)\n"
+    "    --cachedir      Set the directory to cache objects in (default = .berry-cache)\n"
+    "    --time-trace    Write a trace of the build's timings to the given JSON file\n"
+    "                    :: viewable in chrome://tracing or Perfetto\n\n";
 
 template<typename ...Args>
 static void usageError(const std::string fmt, Args&&... args) {
@@ -57,6 +70,15 @@ enum OptName {
     OPT_NOWARN,
     OPT_OPTLEVEL,
     OPT_IMPORT,
+    OPT_JOBS,
+    OPT_PARCHECK,
+    OPT_CACHEDIR,
+    OPT_NOCACHE,
+    OPT_SNAPSHOTSTD,
+    OPT_SERVER,
+    OPT_TIMETRACE,
+    OPT_STATS,
+    OPT_MEMREPORT,
 
     OPTIONS_COUNT
 };
@@ -82,6 +104,15 @@ bool opt_requires_value[OPTIONS_COUNT] = {
     true,   // OPT_NOWARN
     true,   // OPT_OPTLEVEL
     true,   // OPT_IMPORT
+    true,   // OPT_JOBS
+    false,  // OPT_PARCHECK
+    true,   // OPT_CACHEDIR
+    false,  // OPT_NOCACHE
+    false,  // OPT_SNAPSHOTSTD
+    false,  // OPT_SERVER
+    true,   // OPT_TIMETRACE
+    false,  // OPT_STATS
+    false,  // OPT_MEMREPORT
 };
 
 std::unordered_map<char, OptName> opt_shortnames {
@@ -98,7 +129,9 @@ std::unordered_map<char, OptName> opt_shortnames {
     { 'W', OPT_WARN },
     { 'w', OPT_NOWARN },
     { 'O', OPT_OPTLEVEL },
-    { 'I', OPT_IMPORT }
+    { 'I', OPT_IMPORT },
+    { 'j', OPT_JOBS },
+    { 'P', OPT_PARCHECK }
 };
 
 std::unordered_map<std::string_view, OptName> opt_longnames {
@@ -115,7 +148,16 @@ std::unordered_map<std::string_view, OptName> opt_longnames {
     { "warn", OPT_WARN },
     { "nowarn", OPT_NOWARN },
     { "optlevel", OPT_OPTLEVEL },
-    { "import", OPT_IMPORT }
+    { "import", OPT_IMPORT },
+    { "jobs", OPT_JOBS },
+    { "parcheck", OPT_PARCHECK },
+    { "cachedir", OPT_CACHEDIR },
+    { "nocache", OPT_NOCACHE },
+    { "snapshot-std", OPT_SNAPSHOTSTD },
+    { "server", OPT_SERVER },
+    { "time-trace", OPT_TIMETRACE },
+    { "stats", OPT_STATS },
+    { "mem-report", OPT_MEMREPORT }
 };
 
 static bool getArg(Arg& data, int& argc, char**& argv) {
@@ -135,6 +177,12 @@ static bool getArg(Arg& data, int& argc, char**& argv) {
                 usageError("{} requires a value", saved_opt_name);
             } else if (arg[1] == '-' && arg.size() > 2) {
                 std::string_view opt_name_str = arg.substr(2);
+
+                // Long options can be given their value as --name=value.
+                auto eq_pos = opt_name_str.find('=');
+                if (eq_pos != std::string_view::npos) {
+                    opt_name_str = opt_name_str.substr(0, eq_pos);
+                }
                 
                 auto it = opt_longnames.find(opt_name_str);
                 if (it == opt_longnames.end()) {
@@ -142,6 +190,14 @@ static bool getArg(Arg& data, int& argc, char**& argv) {
                 }
 
                 data.name = it->second;
+                if (eq_pos != std::string_view::npos) {
+                    if (!opt_requires_value[data.name]) {
+                        usageError("--{} does not take a value", opt_name_str);
+                    }
+
+                    data.value = arg.substr(eq_pos + 3);
+                    return true;
+                }
             } else if (arg[1] != '-') {
                 char opt_name_ch = arg[1];
 
@@ -185,7 +241,17 @@ std::unordered_map<std::string_view, OutputFormat> out_fmt_names {
     { "shared", OUTFMT_SHARED },
     { "obj", OUTFMT_OBJ },
     { "asm", OUTFMT_ASM },
-    { "llvm", OUTFMT_LLVM }
+    { "llvm", OUTFMT_LLVM },
+    { "check", OUTFMT_CHECK }
+};
+
+std::unordered_map<std::string_view, OptLevel> opt_level_names {
+    { "0", OPTLVL_O0 },
+    { "1", OPTLVL_O1 },
+    { "2", OPTLVL_O2 },
+    { "3", OPTLVL_O3 },
+    { "s", OPTLVL_OS },
+    { "z", OPTLVL_OZ }
 };
 
 std::unordered_map<std::string_view, DebugInfoFormat> dbg_fmt_names {
@@ -196,6 +262,9 @@ std::unordered_map<std::string_view, DebugInfoFormat> dbg_fmt_names {
     { "msvc", DBGI_CODEVIEW }
 };
 
+// run_server indicates whether the compiler should run as a compile server.
+static bool run_server = false;
+
 static void parseArgs(BuildConfig& cfg, int argc, char* argv[]) {
     // Shift off the process name argument.
     argv++;
@@ -219,7 +288,7 @@ static void parseArgs(BuildConfig& cfg, int argc, char* argv[]) {
             cfg.should_emit_debug = true;
             break;
         case OPT_VERBOSE:
-            // TODO
+            cfg.verbose = true;
             break;
         case OPT_VERSION:
             std::cout << BERRYC_VERSION << "\n\n";
@@ -260,26 +329,58 @@ static void parseArgs(BuildConfig& cfg, int argc, char* argv[]) {
             // TODO
             break;
         case OPT_OPTLEVEL: {
+            auto it = opt_level_names.find(arg.value);
+            if (it == opt_level_names.end()) {
+                usageError("optlevel must be one of 0, 1, 2, 3, s, or z");
+            }
+
+            cfg.opt_level = it->second;
+        } break;
+        case OPT_IMPORT:
+            cfg.import_paths.emplace_back(arg.value);
+            break;
+        case OPT_JOBS: {
             try {
-                int opt_level = std::stoi(std::string(arg.value));
-                if (0 <= opt_level && opt_level < 4) {
-                    cfg.opt_level = opt_level;
+                int n_jobs = std::stoi(std::string(arg.value));
+                if (n_jobs > 0) {
+                    cfg.n_jobs = n_jobs;
                 } else {
                     throw std::out_of_range{""};
                 }
             } catch (std::invalid_argument& ex_ia) {
-                usageError("could not convert optlevel to string: {}", ex_ia.what());
+                usageError("could not convert jobs to an integer: {}", ex_ia.what());
             } catch (std::out_of_range& ex_oor) {
-                usageError("optlevel must be between 0 and 3");
+                usageError("jobs must be a positive integer");
             }
         } break;
-        case OPT_IMPORT:
-            cfg.import_paths.emplace_back(arg.value);
+        case OPT_PARCHECK:
+            cfg.parallel_check_bodies = true;
+            break;
+        case OPT_CACHEDIR:
+            cfg.cache_dir = arg.value;
+            break;
+        case OPT_NOCACHE:
+            cfg.cache_dir.clear();
+            break;
+        case OPT_SNAPSHOTSTD:
+            cfg.snapshot_std = true;
+            break;
+        case OPT_SERVER:
+            run_server = true;
+            break;
+        case OPT_TIMETRACE:
+            cfg.time_trace_path = arg.value;
+            break;
+        case OPT_STATS:
+            cfg.show_stats = true;
+            break;
+        case OPT_MEMREPORT:
+            cfg.mem_report = true;
             break;
         }
     }
 
-    if (cfg.input_path.size() == 0) {
+    if (cfg.input_path.size() == 0 && !cfg.snapshot_std && !run_server) {
         usageError("missing input path");
     }
 }
@@ -289,6 +390,16 @@ int main(int argc, char* argv[]) {
 
     parseArgs(cfg, argc, argv);
 
+    if (run_server) {
+        try {
+            RunServer(GetServerSocketPath());
+        } catch (CompileError&) {
+            // The error has already been reported.
+        }
+
+        return 1;
+    }
+
     // Determine output format by extension.
     if (cfg.out_fmt == OUTFMT_DEFAULT) {
         auto out_path_fs = fs::path(cfg.out_path);
@@ -308,6 +419,15 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    // Builds are forwarded to the compile server if there is one.  If it can't
+    // be reached, the build is just run locally.
+    if (getenv(BERRY_SERVER_ENV_VAR) != nullptr) {
+        bool build_ok;
+        if (ForwardToServer(GetServerSocketPath(), cfg, build_ok)) {
+            return build_ok ? 0 : 1;
+        }
+    }
+
     if (!Compile(cfg)) {
         return 1;
     }
@@ -0,0 +1,108 @@
+#include "mapped_file.hpp"
+
+#if OS_WINDOWS
+    #define WIN32_LEAN_AND_MEAN 1
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+#if OS_WINDOWS
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+
+    HANDLE file_handle = CreateFileA(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file_handle);
+        return false;
+    }
+
+    // The mapping keeps the file open so its handle can be closed right away.
+    mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file_handle);
+    if (mapping_handle == nullptr) {
+        return false;
+    }
+
+    data = (const char*)MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        CloseHandle(mapping_handle);
+        mapping_handle = nullptr;
+        return false;
+    }
+
+    size = (size_t)file_size.QuadPart;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+        CloseHandle(mapping_handle);
+
+        data = nullptr;
+        size = 0;
+        mapping_handle = nullptr;
+    }
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    // The mapping keeps the file open so its descriptor can be closed right
+    // away.
+    void* addr = mmap(nullptr, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+
+    data = (const char*)addr;
+    size = (size_t)file_stat.st_size;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data != nullptr) {
+        munmap((void*)data, size);
+
+        data = nullptr;
+        size = 0;
+    }
+}
+
+#endif
@@ -1,13 +1,75 @@
 #include "base.hpp"
 
 #include <iostream>
+#include <atomic>
+#include <mutex>
 
-static int err_count = 0;
+// err_count is atomic since errors can be reported from worker threads.
+static std::atomic<int> err_count = 0;
 
 int ErrorCount() {
     return err_count;
 }
 
+void ResetErrorCount() {
+    err_count = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// curr_diag_buff is the diagnostic buffer the current thread is reporting to.
+// If it is null, diagnostics are written directly to the console.
+static thread_local DiagnosticBuffer* curr_diag_buff = nullptr;
+
+CaptureDiagnostics::CaptureDiagnostics(DiagnosticBuffer& buff)
+: prev_buff(curr_diag_buff)
+{
+    curr_diag_buff = &buff;
+}
+
+CaptureDiagnostics::~CaptureDiagnostics() {
+    curr_diag_buff = prev_buff;
+}
+
+// process_diag_buff is the diagnostic buffer of threads which aren't capturing
+// their own diagnostics.  If it is null, they write directly to the console.
+// It is shared between threads, so it is guarded by process_diag_mutex.
+static DiagnosticBuffer* process_diag_buff = nullptr;
+static std::mutex process_diag_mutex;
+
+CaptureProcessDiagnostics::CaptureProcessDiagnostics(DiagnosticBuffer& buff) {
+    std::lock_guard<std::mutex> lock(process_diag_mutex);
+    Assert(process_diag_buff == nullptr, "process diagnostics are already being captured");
+    process_diag_buff = &buff;
+}
+
+CaptureProcessDiagnostics::~CaptureProcessDiagnostics() {
+    std::lock_guard<std::mutex> lock(process_diag_mutex);
+    process_diag_buff = nullptr;
+}
+
+// emitDiagnostic displays a formatted diagnostic message.
+static void emitDiagnostic(const std::string& msg) {
+    if (curr_diag_buff) {
+        curr_diag_buff->text.append(msg);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(process_diag_mutex);
+    if (process_diag_buff) {
+        process_diag_buff->text.append(msg);
+    } else {
+        fputs(msg.c_str(), stderr);
+    }
+}
+
+void DiagnosticBuffer::Flush() {
+    // Buffers can be nested: a task which is itself capturing diagnostics may
+    // flush the buffers of the subtasks it ran into its own buffer.
+    emitDiagnostic(text);
+    text.clear();
+}
+
 /* -------------------------------------------------------------------------- */
 
 void impl_ReportCompileError(
@@ -17,12 +79,12 @@ void impl_ReportCompileError(
 ) {
     err_count++;
 
-    fprintf(
-        stderr, "error: %s:%zu:%zu: %s\n\n", 
-        display_path.c_str(), 
+    emitDiagnostic(std::format(
+        "error: {}:{}:{}: {}\n\n", 
+        display_path, 
         span.start_line, span.start_col, 
-        message.c_str()
-    );
+        message
+    ));
 }
 
 void impl_Panic(const std::string& msg) {
@@ -33,7 +95,7 @@ void impl_Panic(const std::string& msg) {
 void impl_Fatal(const std::string& msg) {
     err_count++;
 
-    fprintf(stderr, "error: %s\n\n", msg.c_str());
+    emitDiagnostic(std::format("error: {}\n\n", msg));
     
     throw CompileError{};
 }
@@ -41,5 +103,5 @@ void impl_Fatal(const std::string& msg) {
 void impl_Error(const std::string& msg) {
     err_count++;
     
-    fprintf(stderr, "error: %s\n\n", msg.c_str());
+    emitDiagnostic(std::format("error: {}\n\n", msg));
 }
\ No newline at end of file
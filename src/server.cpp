@@ -0,0 +1,554 @@
+#include "server.hpp"
+
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+
+#if OS_WINDOWS
+    #define WIN32_LEAN_AND_MEAN 1
+    #include <winsock2.h>
+    #include <afunix.h>
+
+    typedef SOCKET socket_t;
+    #define INVALID_SOCKET_HANDLE INVALID_SOCKET
+    #define closeSocket closesocket
+#else
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+    #include <signal.h>
+
+    typedef int socket_t;
+    #define INVALID_SOCKET_HANDLE (-1)
+    #define closeSocket close
+#endif
+
+// SEND_FLAGS are the flags passed to send.  Sending to a peer which has hung up
+// must fail with EPIPE rather than raise SIGPIPE and kill the process.  Where
+// MSG_NOSIGNAL is missing, the server ignores SIGPIPE instead.
+#ifdef MSG_NOSIGNAL
+    #define SEND_FLAGS MSG_NOSIGNAL
+#else
+    #define SEND_FLAGS 0
+#endif
+
+namespace fs = std::filesystem;
+
+// The magic string is bumped whenever the protocol changes so that clients and
+// servers of different versions never talk to each other.
+#define SERVER_MAGIC "berry-server-1:" BERRYC_VERSION
+
+// SERVER_MAX_MESSAGE_SIZE is the largest message the server or client accepts.
+// It bounds the buffer allocated for a message before any of it is received.
+#define SERVER_MAX_MESSAGE_SIZE ((uint64_t)64 << 20)
+
+/* -------------------------------------------------------------------------- */
+
+// BadMessage is thrown when a malformed message is received.
+struct BadMessage {};
+
+// MessageWriter encodes a message.  Like module interface files, integers are
+// written as 64-bit little endian values and strings as their length followed
+// by their bytes.
+class MessageWriter {
+    std::string buff;
+
+public:
+    inline const std::string& Data() const { return buff; }
+
+    void WriteU64(uint64_t value) {
+        for (int i = 0; i < 8; i++) {
+            buff.push_back((char)(value >> (i * 8)));
+        }
+    }
+
+    void WriteStr(std::string_view str) {
+        WriteU64(str.size());
+        buff.append(str);
+    }
+
+    void WriteStrs(const std::vector<std::string>& strs) {
+        WriteU64(strs.size());
+        for (auto& str : strs) {
+            WriteStr(str);
+        }
+    }
+};
+
+// MessageReader decodes a message.
+class MessageReader {
+    std::string_view buff;
+    size_t pos { 0 };
+
+public:
+    MessageReader(std::string_view buff)
+    : buff(buff)
+    {}
+
+    uint64_t ReadU64() {
+        if (buff.size() - pos < 8) {
+            throw BadMessage{};
+        }
+
+        uint64_t value = 0;
+        for (int i = 0; i < 8; i++) {
+            value |= (uint64_t)(uint8_t)buff[pos++] << (i * 8);
+        }
+
+        return value;
+    }
+
+    std::string ReadStr() {
+        auto len = ReadU64();
+        if (buff.size() - pos < len) {
+            throw BadMessage{};
+        }
+
+        std::string str(buff.substr(pos, len));
+        pos += len;
+        return str;
+    }
+
+    std::vector<std::string> ReadStrs() {
+        // Every string takes at least 8 bytes, so a count which doesn't fit in
+        // the rest of the message is rejected before allocating for it.
+        auto n_strs = ReadU64();
+        if (n_strs > (buff.size() - pos) / 8) {
+            throw BadMessage{};
+        }
+
+        std::vector<std::string> strs(n_strs);
+        for (auto& str : strs) {
+            str = ReadStr();
+        }
+
+        return strs;
+    }
+};
+
+/* -------------------------------------------------------------------------- */
+
+static void writeConfig(MessageWriter& w, const BuildConfig& cfg) {
+    w.WriteStr(cfg.input_path);
+    w.WriteStrs(cfg.import_paths);
+    w.WriteStr(cfg.out_path);
+    w.WriteU64(cfg.out_fmt);
+    w.WriteU64(cfg.should_emit_debug);
+    w.WriteU64(cfg.debug_fmt);
+    w.WriteStrs(cfg.libs);
+    w.WriteStrs(cfg.lib_paths);
+    w.WriteU64(cfg.opt_level);
+    w.WriteU64(cfg.n_jobs);
+    w.WriteU64(cfg.parallel_check_bodies);
+    w.WriteStr(cfg.cache_dir);
+    w.WriteU64(cfg.snapshot_std);
+    w.WriteU64(cfg.verbose);
+    w.WriteStr(cfg.time_trace_path);
+    w.WriteU64(cfg.show_stats);
+    w.WriteU64(cfg.mem_report);
+}
+
+static void readConfig(MessageReader& r, BuildConfig& cfg) {
+    cfg.input_path = r.ReadStr();
+    cfg.import_paths = r.ReadStrs();
+    cfg.out_path = r.ReadStr();
+    cfg.out_fmt = (OutputFormat)r.ReadU64();
+    cfg.should_emit_debug = r.ReadU64();
+    cfg.debug_fmt = (DebugInfoFormat)r.ReadU64();
+    cfg.libs = r.ReadStrs();
+    cfg.lib_paths = r.ReadStrs();
+    cfg.opt_level = (OptLevel)r.ReadU64();
+    cfg.n_jobs = (int)r.ReadU64();
+    cfg.parallel_check_bodies = r.ReadU64();
+    cfg.cache_dir = r.ReadStr();
+    cfg.snapshot_std = r.ReadU64();
+    cfg.verbose = r.ReadU64();
+    cfg.time_trace_path = r.ReadStr();
+    cfg.show_stats = r.ReadU64();
+    cfg.mem_report = r.ReadU64();
+
+    if (cfg.out_fmt >= OUTFMT_DEFAULT || cfg.debug_fmt >= DBGIS_COUNT || cfg.opt_level >= OPTLVLS_COUNT) {
+        throw BadMessage{};
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool initSockets() {
+#if OS_WINDOWS
+    static bool initialized = false;
+    if (!initialized) {
+        WSADATA wsa_data;
+        initialized = WSAStartup(MAKEWORD(2, 2), &wsa_data) == 0;
+    }
+
+    return initialized;
+#else
+    return true;
+#endif
+}
+
+static bool makeSocketAddr(const std::string& socket_path, sockaddr_un& addr) {
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+
+    memcpy(addr.sun_path, socket_path.data(), socket_path.size());
+    return true;
+}
+
+static bool sendAll(socket_t sock, const char* data, size_t len) {
+    while (len > 0) {
+        // A failed send (eg. EPIPE) means the peer is gone: the caller just
+        // drops the connection.
+        auto n = send(sock, data, (int)std::min(len, (size_t)(1 << 20)), SEND_FLAGS);
+        if (n <= 0) {
+            return false;
+        }
+
+        data += n;
+        len -= n;
+    }
+
+    return true;
+}
+
+static bool recvAll(socket_t sock, char* data, size_t len) {
+    while (len > 0) {
+        auto n = recv(sock, data, (int)std::min(len, (size_t)(1 << 20)), 0);
+        if (n <= 0) {
+            return false;
+        }
+
+        data += n;
+        len -= n;
+    }
+
+    return true;
+}
+
+// sendMessage sends the message encoded by w prefixed by its length.
+static bool sendMessage(socket_t sock, const MessageWriter& w) {
+    MessageWriter len_w;
+    len_w.WriteU64(w.Data().size());
+
+    return sendAll(sock, len_w.Data().data(), 8) && sendAll(sock, w.Data().data(), w.Data().size());
+}
+
+// recvMessage receives a message sent by sendMessage.  Messages larger than
+// SERVER_MAX_MESSAGE_SIZE are rejected.
+static bool recvMessage(socket_t sock, std::string& msg) {
+    char len_buff[8];
+    if (!recvAll(sock, len_buff, 8)) {
+        return false;
+    }
+
+    MessageReader len_r({ len_buff, 8 });
+    auto len = len_r.ReadU64();
+    if (len > SERVER_MAX_MESSAGE_SIZE) {
+        return false;
+    }
+
+    msg.resize(len);
+    return recvAll(sock, msg.data(), msg.size());
+}
+
+/* -------------------------------------------------------------------------- */
+
+// getDefaultSocketDir returns the directory containing the default server
+// socket.  On Unix, it is a directory private to the current user inside the
+// shared temp directory.  On Windows, the temp directory is already private to
+// the user.
+static fs::path getDefaultSocketDir() {
+    std::error_code ec;
+    auto temp_dir = fs::temp_directory_path(ec);
+    if (ec) {
+        temp_dir = fs::current_path();
+    }
+
+#if OS_WINDOWS
+    return temp_dir;
+#else
+    return temp_dir / ("berry-" + std::to_string(getuid()));
+#endif
+}
+
+std::string GetServerSocketPath() {
+    const char* env_path = getenv(BERRY_SERVER_ENV_VAR);
+    if (env_path != nullptr && *env_path != '\0') {
+        return env_path;
+    }
+
+    return (getDefaultSocketDir() / "berry-server.sock").string();
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if !OS_WINDOWS
+
+// makePrivateDir creates the directory dir which only the current user can
+// access.  If it already exists, it must be a real directory owned by the
+// current user that no one else can access: otherwise, another user could
+// replace the server's socket.
+static void makePrivateDir(const fs::path& dir) {
+    if (mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) {
+        ReportFatal("creating server socket directory {}: {}", dir.string(), strerror(errno));
+    }
+
+    struct stat dir_stat;
+    if (lstat(dir.c_str(), &dir_stat) != 0) {
+        ReportFatal("checking server socket directory {}: {}", dir.string(), strerror(errno));
+    }
+
+    if (!S_ISDIR(dir_stat.st_mode) || dir_stat.st_uid != getuid() || (dir_stat.st_mode & 0077) != 0) {
+        ReportFatal("server socket directory {} must be a directory only accessible by its owner", dir.string());
+    }
+}
+
+// getPeerUid gets the ID of the user of the process connected on sock.
+static bool getPeerUid(socket_t sock, uid_t& uid) {
+#if OS_LINUX
+    struct ucred cred;
+    socklen_t cred_len = sizeof(cred);
+    if (getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) != 0) {
+        return false;
+    }
+
+    uid = cred.uid;
+    return true;
+#else
+    gid_t gid;
+    return getpeereid(sock, &uid, &gid) == 0;
+#endif
+}
+
+// isOwnedBy returns whether the file or directory at path is owned by uid.
+static bool isOwnedBy(const fs::path& path, uid_t uid) {
+    struct stat path_stat;
+    return stat(path.c_str(), &path_stat) == 0 && path_stat.st_uid == uid;
+}
+
+// checkClientPaths reports an error if the client whose user is uid doesn't own
+// the working directory cwd or the output path of cfg.  The output path doesn't
+// have to exist yet, but the directory it is created in must then be owned by
+// the client.  This keeps the server from writing anywhere its client couldn't.
+static bool checkClientPaths(const std::string& cwd, const BuildConfig& cfg, uid_t uid) {
+    if (!fs::path(cwd).is_absolute() || !isOwnedBy(cwd, uid)) {
+        ReportError("client working directory {} is not owned by the client", cwd);
+        return false;
+    }
+
+    auto out_path = fs::path(cwd) / cfg.out_path;
+
+    std::error_code ec;
+    if (!fs::exists(out_path, ec)) {
+        out_path = out_path.parent_path();
+    }
+
+    if (!isOwnedBy(out_path, uid)) {
+        ReportError("output path {} is not owned by the client", cfg.out_path);
+        return false;
+    }
+
+    return true;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+// isForwardable returns whether the build described by cfg can be run by the
+// server.  Verbose output, statistics and memory reports are printed directly
+// to the console rather than reported as diagnostics, so the server has no way
+// to send them back: builds which ask for them are run locally.
+static bool isForwardable(const BuildConfig& cfg) {
+    return !cfg.verbose && !cfg.show_stats && !cfg.mem_report;
+}
+
+// runBuild runs a build requested by a client whose working directory is cwd.
+// It returns whether the build succeeded.
+static bool runBuild(const std::string& cwd, const BuildConfig& cfg) {
+    if (!isForwardable(cfg)) {
+        ReportError("verbose output, statistics and memory reports can't be sent back by the server");
+        return false;
+    }
+
+#if !OS_WINDOWS
+    // The client's user has already been checked to be the server's user.
+    if (!checkClientPaths(cwd, cfg, getuid())) {
+        return false;
+    }
+#endif
+
+    std::error_code ec;
+    fs::current_path(cwd, ec);
+    if (ec) {
+        ReportError("changing to client working directory: {}", ec.message());
+        return false;
+    }
+
+    return Compile(cfg);
+}
+
+// handleRequest runs the build requested by a client connected on sock.
+static void handleRequest(socket_t sock) {
+#if !OS_WINDOWS
+    // Only builds requested by the user running the server are accepted.
+    // Windows has no way to get the user of a socket's peer: there, the
+    // socket is protected by being in the user's private temp directory.
+    uid_t peer_uid;
+    if (!getPeerUid(sock, peer_uid) || peer_uid != getuid()) {
+        return;
+    }
+#endif
+
+    std::string req;
+    if (!recvMessage(sock, req)) {
+        return;
+    }
+
+    BuildConfig cfg;
+    std::string cwd;
+    try {
+        MessageReader r(req);
+        if (r.ReadStr() != SERVER_MAGIC) {
+            return;
+        }
+
+        cwd = r.ReadStr();
+        readConfig(r, cfg);
+    } catch (BadMessage&) {
+        return;
+    }
+
+    // Builds are run one at a time since the working directory and the error
+    // count are global to the process.  The diagnostics of every thread are
+    // captured so that none of them are lost to the server's console.
+    DiagnosticBuffer diags;
+    bool build_ok = false;
+    {
+        CaptureProcessDiagnostics capture(diags);
+        ResetErrorCount();
+
+        build_ok = runBuild(cwd, cfg);
+    }
+
+    MessageWriter w;
+    w.WriteU64(build_ok);
+    w.WriteStr(diags.text);
+    sendMessage(sock, w);
+}
+
+void RunServer(const std::string& socket_path) {
+    if (!initSockets()) {
+        ReportFatal("failed to initialize sockets");
+    }
+
+    sockaddr_un addr;
+    if (!makeSocketAddr(socket_path, addr)) {
+        ReportFatal("server socket path is too long: {}", socket_path);
+    }
+
+#if !OS_WINDOWS
+    auto socket_dir = fs::path(socket_path).parent_path();
+    if (socket_dir == getDefaultSocketDir()) {
+        makePrivateDir(socket_dir);
+    }
+
+    // A client which disconnects before its reply is sent (eg. because the
+    // user interrupted it) must not take the server down with it.
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    socket_t server_sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server_sock == INVALID_SOCKET_HANDLE) {
+        ReportFatal("failed to create server socket");
+    }
+
+    // A socket left behind by a previous server has to be removed.
+    std::error_code ec;
+    fs::remove(socket_path, ec);
+
+    // The socket is only made accessible to the current user before any
+    // connections are accepted on it.
+    bool listening = bind(server_sock, (sockaddr*)&addr, sizeof(addr)) == 0;
+#if !OS_WINDOWS
+    listening = listening && chmod(socket_path.c_str(), 0600) == 0;
+#endif
+    listening = listening && listen(server_sock, 16) == 0;
+
+    if (!listening) {
+        closeSocket(server_sock);
+        ReportFatal("failed to listen on server socket: {}", socket_path);
+    }
+
+    std::cout << "berry server listening on " << socket_path << '\n';
+
+    while (true) {
+        socket_t client_sock = accept(server_sock, nullptr, nullptr);
+        if (client_sock == INVALID_SOCKET_HANDLE) {
+            continue;
+        }
+
+        handleRequest(client_sock);
+        closeSocket(client_sock);
+    }
+}
+
+bool ForwardToServer(const std::string& socket_path, const BuildConfig& cfg, bool& build_ok) {
+    if (!isForwardable(cfg) || !initSockets()) {
+        return false;
+    }
+
+    sockaddr_un addr;
+    if (!makeSocketAddr(socket_path, addr)) {
+        return false;
+    }
+
+    socket_t sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock == INVALID_SOCKET_HANDLE) {
+        return false;
+    }
+
+    if (connect(sock, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        closeSocket(sock);
+        return false;
+    }
+
+    std::error_code ec;
+    auto cwd = fs::current_path(ec);
+    if (ec) {
+        closeSocket(sock);
+        return false;
+    }
+
+    MessageWriter w;
+    w.WriteStr(SERVER_MAGIC);
+    w.WriteStr(cwd.string());
+    writeConfig(w, cfg);
+
+    std::string resp;
+    bool got_resp = sendMessage(sock, w) && recvMessage(sock, resp);
+    closeSocket(sock);
+
+    if (!got_resp) {
+        return false;
+    }
+
+    try {
+        MessageReader r(resp);
+        build_ok = r.ReadU64();
+
+        auto diags = r.ReadStr();
+        fputs(diags.c_str(), stderr);
+    } catch (BadMessage&) {
+        return false;
+    }
+
+    return true;
+}
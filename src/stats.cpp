@@ -0,0 +1,216 @@
+#include "stats.hpp"
+
+#include <iostream>
+#include <mutex>
+#include <algorithm>
+
+bool stats_enabled = false;
+
+// StatCounters are the counters collected by a single thread.
+struct StatCounters {
+    uint64_t counters[STATS_COUNT];
+    uint64_t ast_nodes[ASTS_COUNT];
+    uint64_t hir_nodes[HIRS_COUNT];
+    uint64_t types[TYPES_COUNT];
+};
+
+// ModuleCodeStats is the size of the LLVM module generated for a module.
+struct ModuleCodeStats {
+    std::string mod_name;
+    uint64_t n_funcs;
+    uint64_t n_instrs;
+    uint64_t n_opt_instrs;
+};
+
+// stat_threads holds the counters of all the threads which have counted
+// anything since statistics were started.
+static std::vector<std::unique_ptr<StatCounters>> stat_threads;
+static std::vector<ModuleCodeStats> mod_code_stats;
+static std::mutex stats_mutex;
+
+// stats_gen is incremented every time statistics are started so that threads
+// don't keep using their counters from a previous build.
+static uint64_t stats_gen = 0;
+
+static thread_local StatCounters* curr_counters = nullptr;
+static thread_local uint64_t curr_counters_gen = 0;
+
+// getStatCounters returns the counters of the current thread.
+static StatCounters& getStatCounters() {
+    if (curr_counters == nullptr || curr_counters_gen != stats_gen) {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+
+        // The counters are value-initialized (ie. zeroed).
+        auto& counters = stat_threads.emplace_back(std::make_unique<StatCounters>());
+        curr_counters = counters.get();
+        curr_counters_gen = stats_gen;
+    }
+
+    return *curr_counters;
+}
+
+void StartStats() {
+    stat_threads.clear();
+    mod_code_stats.clear();
+    stats_gen++;
+    stats_enabled = true;
+}
+
+void RecordModuleCodeStats(std::string_view mod_name, uint64_t n_funcs, uint64_t n_instrs, uint64_t n_opt_instrs) {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    mod_code_stats.emplace_back(std::string(mod_name), n_funcs, n_instrs, n_opt_instrs);
+}
+
+void impl_CountStat(StatCounter counter, uint64_t n) {
+    getStatCounters().counters[counter] += n;
+}
+
+void impl_CountAstNode(AstKind kind) {
+    getStatCounters().ast_nodes[kind]++;
+}
+
+void impl_CountHirNode(HirKind kind) {
+    getStatCounters().hir_nodes[kind]++;
+}
+
+void impl_CountType(TypeKind kind) {
+    getStatCounters().types[kind]++;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static const char* stat_counter_names[] = {
+    "tokens lexed",
+    "comptime evaluations",
+    "bounds checks emitted",
+    "bounds checks kept",
+    "overflow checks emitted",
+    "overflow checks kept",
+    "divide checks emitted",
+    "divide checks kept",
+};
+static_assert(std::size(stat_counter_names) == STATS_COUNT, "missing stat counter name");
+
+// CheckCounters are the counters of one kind of runtime check.  The number of
+// checks elided by the optimizer is the number emitted less the number kept.
+struct CheckCounters {
+    const char* elided_name;
+    StatCounter emitted;
+    StatCounter kept;
+};
+
+static const CheckCounters check_counters[] = {
+    { "bounds checks elided", STAT_BOUNDS_CHECKS, STAT_BOUNDS_CHECKS_KEPT },
+    { "overflow checks elided", STAT_OVERFLOW_CHECKS, STAT_OVERFLOW_CHECKS_KEPT },
+    { "divide checks elided", STAT_DIVIDE_CHECKS, STAT_DIVIDE_CHECKS_KEPT },
+};
+
+static const char* ast_kind_names[] = {
+    "AST_FUNC", "AST_VAR", "AST_CONST", "AST_TYPEDEF", "AST_METHOD",
+    "AST_FACTORY", "AST_BLOCK", "AST_IF", "AST_WHILE", "AST_DO_WHILE",
+    "AST_FOR", "AST_MATCH", "AST_UNSAFE", "AST_ASSIGN", "AST_INCDEC",
+    "AST_RETURN", "AST_BREAK", "AST_CONTINUE", "AST_FALLTHRU", "AST_TEST_MATCH",
+    "AST_CAST", "AST_BINOP", "AST_UNOP", "AST_ADDR", "AST_DEREF", "AST_CALL",
+    "AST_INDEX", "AST_SLICE", "AST_SELECTOR", "AST_NEW", "AST_NEW_ARRAY",
+    "AST_NEW_STRUCT", "AST_ARRAY_LIT", "AST_STRUCT_LIT", "AST_IDENT",
+    "AST_NUM_LIT", "AST_FLOAT_LIT", "AST_BOOL_LIT", "AST_RUNE_LIT",
+    "AST_STRING_LIT", "AST_NULL", "AST_MACRO_SIZEOF", "AST_MACRO_ALIGNOF",
+    "AST_MACRO_ATOMIC_CAS_WEAK", "AST_MACRO_ATOMIC_LOAD",
+    "AST_MACRO_ATOMIC_STORE", "AST_TYPE_PRIM", "AST_TYPE_ARRAY",
+    "AST_TYPE_SLICE", "AST_TYPE_FUNC", "AST_TYPE_STRUCT", "AST_TYPE_ENUM",
+    "AST_EXPR_LIST", "AST_NAMED_INIT", "AST_DOT",
+};
+static_assert(std::size(ast_kind_names) == ASTS_COUNT, "missing AST kind name");
+
+static const char* hir_kind_names[] = {
+    "HIR_FUNC", "HIR_GLOBAL_VAR", "HIR_GLOBAL_CONST", "HIR_STRUCT", "HIR_ALIAS",
+    "HIR_ENUM", "HIR_METHOD", "HIR_FACTORY", "HIR_BLOCK", "HIR_IF", "HIR_WHILE",
+    "HIR_DO_WHILE", "HIR_FOR", "HIR_MATCH", "HIR_UNSAFE", "HIR_LOCAL_VAR",
+    "HIR_LOCAL_CONST", "HIR_ASSIGN", "HIR_CPD_ASSIGN", "HIR_INCDEC",
+    "HIR_EXPR_STMT", "HIR_RETURN", "HIR_BREAK", "HIR_CONTINUE", "HIR_FALLTHRU",
+    "HIR_TEST_MATCH", "HIR_CAST", "HIR_BINOP", "HIR_UNOP", "HIR_ADDR",
+    "HIR_DEREF", "HIR_CALL", "HIR_CALL_METHOD", "HIR_CALL_FACTORY", "HIR_INDEX",
+    "HIR_SLICE", "HIR_FIELD", "HIR_DEREF_FIELD", "HIR_NEW", "HIR_NEW_ARRAY",
+    "HIR_NEW_STRUCT", "HIR_ARRAY_LIT", "HIR_STRUCT_LIT", "HIR_ENUM_LIT",
+    "HIR_STATIC_GET", "HIR_IDENT", "HIR_NUM_LIT", "HIR_FLOAT_LIT",
+    "HIR_BOOL_LIT", "HIR_STRING_LIT", "HIR_NULL", "HIR_PATTERN_CAPTURE",
+    "HIR_MACRO_SIZEOF", "HIR_MACRO_ALIGNOF", "HIR_MACRO_ATOMIC_CAS_WEAK",
+    "HIR_MACRO_ATOMIC_LOAD", "HIR_MACRO_ATOMIC_STORE",
+};
+static_assert(std::size(hir_kind_names) == HIRS_COUNT, "missing HIR kind name");
+
+static const char* type_kind_names[] = {
+    "TYPE_INT", "TYPE_FLOAT", "TYPE_BOOL", "TYPE_UNIT", "TYPE_PTR", "TYPE_FUNC",
+    "TYPE_ARRAY", "TYPE_SLICE", "TYPE_STRING", "TYPE_NAMED", "TYPE_ALIAS",
+    "TYPE_STRUCT", "TYPE_ENUM", "TYPE_UNTYP",
+};
+static_assert(std::size(type_kind_names) == TYPES_COUNT, "missing type kind name");
+
+// printKindCounts prints the nonzero counts of a group of kinds along with
+// their total.
+static void printKindCounts(const char* title, const char** names, const uint64_t* counts, size_t n_kinds) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < n_kinds; i++) {
+        total += counts[i];
+    }
+
+    std::cout << std::format("[STATS] {} ({} total)\n", title, total);
+    for (size_t i = 0; i < n_kinds; i++) {
+        if (counts[i] > 0) {
+            std::cout << std::format("    {:<28} {:>10}\n", names[i], counts[i]);
+        }
+    }
+}
+
+void PrintStats() {
+    stats_enabled = false;
+
+    StatCounters totals {};
+    for (auto& thread : stat_threads) {
+        for (size_t i = 0; i < STATS_COUNT; i++) {
+            totals.counters[i] += thread->counters[i];
+        }
+
+        for (size_t i = 0; i < ASTS_COUNT; i++) {
+            totals.ast_nodes[i] += thread->ast_nodes[i];
+        }
+
+        for (size_t i = 0; i < HIRS_COUNT; i++) {
+            totals.hir_nodes[i] += thread->hir_nodes[i];
+        }
+
+        for (size_t i = 0; i < TYPES_COUNT; i++) {
+            totals.types[i] += thread->types[i];
+        }
+    }
+
+    std::cout << "[STATS] Counters\n";
+    for (size_t i = 0; i < STATS_COUNT; i++) {
+        std::cout << std::format("    {:<28} {:>10}\n", stat_counter_names[i], totals.counters[i]);
+    }
+
+    // Inlining can duplicate a check, so more checks can be kept than were
+    // emitted.
+    for (auto& cc : check_counters) {
+        uint64_t n_emitted = totals.counters[cc.emitted], n_kept = totals.counters[cc.kept];
+        std::cout << std::format("    {:<28} {:>10}\n", cc.elided_name, n_emitted > n_kept ? n_emitted - n_kept : 0);
+    }
+
+    printKindCounts("AST nodes", ast_kind_names, totals.ast_nodes, ASTS_COUNT);
+    printKindCounts("HIR nodes", hir_kind_names, totals.hir_nodes, HIRS_COUNT);
+    printKindCounts("Types", type_kind_names, totals.types, TYPES_COUNT);
+
+    // Modules are generated concurrently, so they are sorted by name to keep
+    // the report stable between builds.
+    std::sort(mod_code_stats.begin(), mod_code_stats.end(), [](auto& a, auto& b) {
+        return a.mod_name < b.mod_name;
+    });
+
+    std::cout << "[STATS] LLVM modules (functions, instructions, optimized instructions)\n";
+    for (auto& mcs : mod_code_stats) {
+        std::cout << std::format("    {:<28} {:>10} {:>10} {:>10}\n", mcs.mod_name, mcs.n_funcs, mcs.n_instrs, mcs.n_opt_instrs);
+    }
+
+    stat_threads.clear();
+    mod_code_stats.clear();
+}
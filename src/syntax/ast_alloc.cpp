@@ -1,4 +1,5 @@
 #include "parser.hpp"
+#include "stats.hpp"
 
 static AstNode size_ref_node {};
 
@@ -72,6 +73,8 @@ AstNode* Parser::allocNode(AstKind kind, const TextSpan& span) {
     size_t var_size = ast_variant_sizes[(int)kind];
     size_t full_size = sizeof(AstNode) - LARGEST_AST_VARIANT_SIZE + var_size;
 
+    CountAstNode(kind);
+
     auto* node = (AstNode*)ast_arena.Alloc(full_size);
     node->kind = kind;
     node->span = span;
@@ -2,26 +2,32 @@
 
 #include <stdarg.h>
 #include <ctype.h>
-#include <unordered_map>
 
-Lexer::Lexer(std::ifstream& file_, const SourceFile& src_file_)
-: file(file_)
+#include "scan.hpp"
+#include "stats.hpp"
+
+Lexer::Lexer(std::string_view src_, const SourceFile& src_file_)
+: src(src_)
 , src_file(src_file_)
+, pos(0)
+, tok_start(0)
 , line(1)
 , col(1)
 , start_line(1)
 , start_col(1)
-, rlen(0)
+, alen(0)
 {}
 
 void Lexer::NextToken(Token& tok) {
+    CountStat(STAT_TOKENS);
+
     while (peek()) {
         switch (ahead) {
         case '\n':
         case '\t':
         case '\r':
         case ' ':
-            skip();
+            readAscii(ScanWhitespace(curr(), srcEnd()));
             break;
         case '/':
             mark();
@@ -135,11 +141,19 @@ void Lexer::NextToken(Token& tok) {
     }
 
     tok.kind = TOK_EOF;
+    tok.value = {};
 }
 
 /* -------------------------------------------------------------------------- */
 
-static std::unordered_map<std::string, TokenKind> keyword_patterns {
+// KeywordEntry is an entry in the keyword table.  Empty slots have no name.
+struct KeywordEntry {
+    std::string_view name;
+    TokenKind kind { TOK_IDENT };
+};
+
+// keywords lists every keyword along with its token kind.
+static constexpr KeywordEntry keywords[] {
     { "let", TOK_LET },
     { "const", TOK_CONST },
     { "func", TOK_FUNC },
@@ -183,35 +197,99 @@ static std::unordered_map<std::string, TokenKind> keyword_patterns {
     { "false", TOK_BOOLLIT }
 };
 
-void Lexer::lexKeywordOrIdent(Token& tok) {
-    mark();
-    read();
+// KEYWORD_TABLE_BITS is the log2 of the number of slots in the keyword table.
+#define KEYWORD_TABLE_BITS 7
+
+// keywordKey packs the length and the first, second and last characters of
+// word into a single integer.  These are enough to tell all the keywords apart
+// without looking at the rest of the word.  word must be at least two
+// characters long.
+static constexpr uint32_t keywordKey(std::string_view word) {
+    return (uint32_t)(byte)word[0]
+        | (uint32_t)(byte)word[1] << 8
+        | (uint32_t)(byte)word.back() << 16
+        | (uint32_t)word.size() << 24;
+}
 
-    while (peek() && (isalnum(ahead) || ahead == '_')) {
-        read();
+// KEYWORD_HASH_MULT is the hash multiplier of the keyword table: it puts every
+// keyword in a different slot.  It was found by trying odd multipliers given by
+// a linear congruential generator until one worked:
+//
+//     uint32_t mult = 0x9e3779b9;
+//     while (!<every keyword has its own slot using mult>) {
+//         mult = (mult * 1664525 + 1013904223) | 1;
+//     }
+//
+// Searching at compile time takes too many constexpr evaluation steps, so the
+// search has to be rerun by hand if the keywords change: the static_assert
+// below catches any collision.
+#define KEYWORD_HASH_MULT 0x3910fa75u
+
+// keywordSlot computes the slot of key in the keyword table.
+static constexpr size_t keywordSlot(uint32_t key) {
+    return (uint32_t)(key * KEYWORD_HASH_MULT) >> (32 - KEYWORD_TABLE_BITS);
+}
+
+// KeywordTable is a perfect hash table of the keywords: every keyword has its
+// own slot so looking up a word takes one probe and one comparison.
+struct KeywordTable {
+    // perfect indicates whether every keyword got its own slot.
+    bool perfect;
+
+    KeywordEntry slots[1 << KEYWORD_TABLE_BITS];
+};
+
+// buildKeywordTable puts the keywords in their slots.  This only runs at
+// compile time.
+static constexpr KeywordTable buildKeywordTable() {
+    KeywordTable table { true };
+
+    for (auto& keyword : keywords) {
+        auto& slot = table.slots[keywordSlot(keywordKey(keyword.name))];
+        if (!slot.name.empty()) {
+            table.perfect = false;
+        }
+
+        slot = keyword;
     }
 
-    auto it = keyword_patterns.find(tok_buff);
-    if (it != keyword_patterns.end()) {
-        makeToken(tok, it->second);
-    } else {
-        makeToken(tok, TOK_IDENT);
+    return table;
+}
+
+static constexpr KeywordTable keyword_table = buildKeywordTable();
+static_assert(keyword_table.perfect, "KEYWORD_HASH_MULT puts two keywords in the same slot");
+
+TokenKind KeywordKind(std::string_view word) {
+    // Every keyword is at least two characters long.
+    if (word.size() < 2) {
+        return TOK_IDENT;
     }
+
+    auto& slot = keyword_table.slots[keywordSlot(keywordKey(word))];
+    return slot.name == word ? slot.kind : TOK_IDENT;
+}
+
+
+void Lexer::lexKeywordOrIdent(Token& tok) {
+    mark();
+    readAscii(ScanIdent(curr(), srcEnd()));
+
+    makeToken(tok, KeywordKind(src.substr(tok_start, pos - tok_start)));
 }
 
 void Lexer::lexDirective(Token& tok) {
     mark();
-    skip();
+    read();
 
     while (peek() && (isalpha(ahead) || ahead == '_')) {
         read();
     }
 
-    if (tok_buff.size() == 0) {
+    if (pos - tok_start == 1) {
         fatal("expected directive name");
     }
 
-    makeToken(tok, TOK_DIRECTIVE);
+    makeToken(tok, TOK_DIRECTIVE, 1);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -258,7 +336,7 @@ nobase:
                 read();
                 expect_digit = false;
             } else if (!expect_digit && ahead == '_') {
-                skip();
+                read();
             } else {
                 break;
             }
@@ -274,7 +352,7 @@ nobase:
                 read();
                 expect_digit = false;
             } else if (!expect_digit && ahead == '_') {
-                skip();
+                read();
             } else {
                 break;
             }
@@ -318,11 +396,15 @@ bool Lexer::readFloatOrIntLit(Token& tok, DigitCheckFunc f_is_digit, char exp_ch
             expect_digit = true;
             read();
         } else if (!expect_digit && ahead == '_') {
-            skip();
+            read();
             continue;
         } else if (f_is_digit(ahead)) {
             expect_digit = false;
             read();
+
+            // Decimal digits are digits in every base this is used for, so
+            // the rest of a run of them can be read at once.
+            readAscii(ScanDecDigits(curr(), srcEnd()));
         } else if (ahead == exp_char_lower || ahead == exp_char_upper) {
             if (expect_digit) {
                 break;
@@ -443,17 +525,19 @@ void Lexer::lexSingle(Token& tok, TokenKind kind) {
 
 void Lexer::lexStrLit(Token& tok) {
     mark();
-    skip();
+    read();
 
     while (peek()) {
         if (ahead == '\n') {
             break;
         } else if (ahead == '\"') {
-            skip();
-            makeToken(tok, TOK_STRLIT);
+            read();
+            makeToken(tok, TOK_STRLIT, 1, 1);
             return;
         } else if (ahead == '\\') {
             readEscapeSeq();
+        } else if (ahead < 0x80) {
+            readAscii(ScanStrChars(curr(), srcEnd()));
         } else {
             read();
         }
@@ -464,7 +548,7 @@ void Lexer::lexStrLit(Token& tok) {
 
 void Lexer::lexRuneLit(Token& tok) {
     mark();
-    skip();
+    read();
 
     if (!peek()) {
         fatal("unclosed rune literal");
@@ -484,9 +568,9 @@ void Lexer::lexRuneLit(Token& tok) {
         fatal("rune contains more than one character");
     }
 
-    skip();
+    read();
 
-    makeToken(tok, TOK_RUNELIT);
+    makeToken(tok, TOK_RUNELIT, 1, 1);
 }
 
 void Lexer::readEscapeSeq() {
@@ -511,7 +595,7 @@ void Lexer::readEscapeSeq() {
         read();
         break;
     default:
-        skip();
+        read();
         fatal("invalid escape sequence");
     }
 }
@@ -519,23 +603,30 @@ void Lexer::readEscapeSeq() {
 /* -------------------------------------------------------------------------- */
 
 void Lexer::skipLineComment() {
-    tok_buff.clear();
-    skip();
+    read();
 
     while (peek() && ahead != '\n') {
-        skip();
+        if (ahead < 0x80) {
+            readAscii(ScanLineComment(curr(), srcEnd()));
+        } else {
+            read();
+        }
     }
 }
 
 void Lexer::skipBlockComment() {
-    tok_buff.clear();
-    skip();
+    read();
 
     while (peek()) {
-        skip();
+        if (ahead != '*' && ahead < 0x80) {
+            readAscii(ScanBlockComment(curr(), srcEnd()));
+            continue;
+        }
+
+        read();
 
         if (ahead == '*' && peek() && ahead == '/') {
-            skip();
+            read();
             return;
         }
     }
@@ -544,55 +635,41 @@ void Lexer::skipBlockComment() {
 /* -------------------------------------------------------------------------- */
 
 void Lexer::mark() {
+    tok_start = pos;
     start_line = line;
     start_col = col;
 }
 
-void Lexer::makeToken(Token& tok, TokenKind kind) {
+void Lexer::makeToken(Token& tok, TokenKind kind, size_t trim_start, size_t trim_end) {
     tok.kind = kind;
-    tok.value = std::move(tok_buff);
+    tok.value = src.substr(tok_start + trim_start, pos - tok_start - trim_start - trim_end);
     tok.span = getSpan();
 }
 
 /* -------------------------------------------------------------------------- */
 
 rune Lexer::read() {
-    rune r;
-    if (rlen > 0) {
-        r = ahead;
-    } else {
-        r = getRune();
-        if (r == -1) {
-            return -1;
-        }
+    if (!peek()) {
+        return -1;
     }
 
-    tok_buff.append(rbuff, rlen);
+    rune r = ahead;
+    pos += alen;
     updatePos(r);
-    rlen = 0;
+    alen = 0;
 
     return r;
 }
 
-rune Lexer::skip() {
-    rune r;
-    if (rlen > 0) {
-        r = ahead;
-    } else {
-        r = getRune();
-        if (r == -1) {
-            return -1;
-        }
-    }
-
-    updatePos(r);
-    rlen = 0;
+void Lexer::readAscii(const char* stop) {
+    AdvanceTextPos(curr(), stop, line, col);
 
-    return r;
+    pos = stop - src.data();
+    alen = 0;
 }
 
 bool Lexer::peek() {
-    if (rlen > 0) {
+    if (alen > 0) {
         return true;
     } else {
         ahead = getRune();
@@ -618,17 +695,16 @@ void Lexer::updatePos(rune r) {
 /* -------------------------------------------------------------------------- */
 
 rune Lexer::getRune() {
-    byte b1 = file.get();
-    if (b1 == 0xff) {
+    if (pos == src.size()) {
         return -1;
     }
-    
-    rbuff[0] = b1;
+
+    byte b1 = src[pos];
 
     int n_bytes = 0;
     int32_t r;
     if ((b1 & 0x80) == 0) { // 0xxxxxxx
-        rlen = 1;
+        alen = 1;
         return b1;
     } else if ((b1 & 0xe0) == 0xc0) { // 110xxxxx
         n_bytes = 1;
@@ -644,18 +720,20 @@ rune Lexer::getRune() {
     }
 
     for (int i = 0; i < n_bytes; i++) {
-        byte b = file.get();
-        if (b == -1) {
+        if (pos + i + 1 == src.size()) {
             fatal("malformed rune: expected {} bytes; got EOF at {} bytes", n_bytes + 1, i + 1);
         }
 
-        rbuff[i+1] = b;
+        byte b = src[pos + i + 1];
+        if ((b & 0xc0) != 0x80) {
+            fatal("malformed rune: invalid continuation byte: {}", b);
+        }
 
         r <<= 6;
         r = r | (b & 0x3f);
     }
 
-    rlen = n_bytes + 1;
+    alen = n_bytes + 1;
 
     return r;
 }
@@ -50,7 +50,7 @@ AstNode* Parser::parseFuncOrMethodDecl(bool exported) {
     AstNode* bind_type = nullptr;
     if (has(TOK_DOT)) {
         bind_type = allocNode(AST_IDENT, name_tok.span);
-        bind_type->an_Ident.name = ast_arena.MoveStr(std::move(name_tok.value));
+        bind_type->an_Ident.name = InternName(name_tok.value);
 
         next();
         name_tok = wantAndGet(TOK_IDENT);
@@ -58,7 +58,7 @@ AstNode* Parser::parseFuncOrMethodDecl(bool exported) {
         if (has(TOK_DOT)) {
             auto* sel_type = allocNode(AST_SELECTOR, SpanOver(bind_type->span, name_tok.span));
             sel_type->an_Sel.expr = bind_type;
-            sel_type->an_Sel.field_name = ast_arena.MoveStr(std::move(name_tok.value));
+            sel_type->an_Sel.field_name = InternName(name_tok.value);
             bind_type = sel_type;
 
             next();
@@ -87,7 +87,7 @@ AstNode* Parser::parseFuncOrMethodDecl(bool exported) {
     if (bind_type != nullptr) {
         auto* amethod = allocNode(AST_METHOD, SpanOver(start_span, end_span));
         amethod->an_Method.bind_type = bind_type;
-        amethod->an_Method.name = global_arena.MoveStr(std::move(name_tok.value));
+        amethod->an_Method.name = InternName(name_tok.value);
         amethod->an_Method.name_span = name_tok.span;
         amethod->an_Method.func_type = afunc_type;
         amethod->an_Method.body = body;
@@ -96,7 +96,7 @@ AstNode* Parser::parseFuncOrMethodDecl(bool exported) {
 
     Symbol* symbol = global_arena.New<Symbol>(
         src_file.parent->id,
-        global_arena.MoveStr(std::move(name_tok.value)),
+        InternName(name_tok.value),
         name_tok.span,
         exported ? SYM_FUNC | SYM_EXPORTED : SYM_FUNC,
         src_file.parent->decls.size(),
@@ -120,7 +120,7 @@ AstNode* Parser::parseFactoryDecl(bool exported) {
 
     auto name_tok = wantAndGet(TOK_IDENT);
     auto* bind_type = allocNode(AST_IDENT, name_tok.span);
-    bind_type->an_Ident.name = ast_arena.MoveStr(std::move(name_tok.value));
+    bind_type->an_Ident.name = InternName(name_tok.value);
 
     if (has(TOK_DOT)) {
         next();
@@ -128,7 +128,7 @@ AstNode* Parser::parseFactoryDecl(bool exported) {
 
         auto* sel_type = allocNode(AST_SELECTOR, SpanOver(bind_type->span, name_tok.span));
         sel_type->an_Sel.expr = bind_type;
-        sel_type->an_Sel.field_name = ast_arena.MoveStr(std::move(name_tok.value));
+        sel_type->an_Sel.field_name = InternName(name_tok.value);
         bind_type = sel_type;
     }
 
@@ -146,7 +146,8 @@ AstNode* Parser::parseFactoryDecl(bool exported) {
 AstNode* Parser::parseFuncSignature() {
     auto start_span = tok.span;
 
-    std::vector<AstFuncParam> params;
+    ScratchScope scratch;
+    ArenaList<AstFuncParam> params(scratch.Get());
     want(TOK_LPAREN);
     if (!has(TOK_RPAREN)) {
         parseFuncParams(params);
@@ -159,13 +160,13 @@ AstNode* Parser::parseFuncSignature() {
     }
 
     auto* afunc_type = allocNode(AST_TYPE_FUNC, SpanOver(start_span, prev.span));
-    afunc_type->an_TypeFunc.params = ast_arena.MoveVec(std::move(params));
+    afunc_type->an_TypeFunc.params = ast_arena.MoveList(params);
     afunc_type->an_TypeFunc.return_type = return_type;
     return afunc_type;
 }
 
-void Parser::parseFuncParams(std::vector<AstFuncParam>& params) {
-    std::unordered_set<std::string_view> param_names;
+void Parser::parseFuncParams(ArenaList<AstFuncParam>& params) {
+    std::unordered_set<std::string_view, NameHash, NameEq> param_names;
     while (true) {
         auto name_toks = parseIdentList();
         auto* type = parseTypeExt();
@@ -173,7 +174,7 @@ void Parser::parseFuncParams(std::vector<AstFuncParam>& params) {
         for (auto& name_tok : name_toks) {
             AstFuncParam aparam {
                 SpanOver(name_tok.span, type->span),
-                global_arena.MoveStr(std::move(name_tok.value)),
+                InternName(name_tok.value),
                 type
             };
 
@@ -181,7 +182,7 @@ void Parser::parseFuncParams(std::vector<AstFuncParam>& params) {
                 error(name_tok.span, "multiple parameters named {}", aparam.name);
             }
 
-            params.push_back(aparam);
+            params.Push(aparam);
             param_names.insert(aparam.name);
         }
         
@@ -219,8 +220,9 @@ AstNode* Parser::parseStructDecl(bool exported) {
     want(TOK_LBRACE);
 
     bool field_exported = false;
-    std::vector<AstStructField> fields;
-    std::unordered_map<std::string_view, size_t> name_map;
+    ScratchScope scratch;
+    ArenaList<AstStructField> fields(scratch.Get());
+    NameMap<size_t> name_map;
     do {
         // TODO: field attrs
 
@@ -239,14 +241,14 @@ AstNode* Parser::parseStructDecl(bool exported) {
         auto field_type = parseTypeExt();
 
         for (auto& field_name_tok : field_name_toks) {
-            auto field_name = global_arena.MoveStr(std::move(field_name_tok.value));
+            auto field_name = InternName(field_name_tok.value);
 
             if (name_map.contains(field_name)) {
                 error(field_name_tok.span, "multiple fields named {}", field_name);
             }
 
-            name_map.emplace(field_name, fields.size());
-            fields.emplace_back(AstStructField{
+            name_map.emplace(field_name, fields.Len());
+            fields.Push(AstStructField{
                 SpanOver(field_name_tok.span, field_type->span),
                 field_name,
                 field_type,
@@ -261,7 +263,7 @@ AstNode* Parser::parseStructDecl(bool exported) {
     auto named_type = AllocType(global_arena, TYPE_NAMED);
     named_type->ty_Named.mod_id = src_file.parent->id;
     named_type->ty_Named.mod_name = src_file.parent->name;  // No need to move to arena here.
-    named_type->ty_Named.name = global_arena.MoveStr(std::move(name_tok.value));
+    named_type->ty_Named.name = InternName(name_tok.value);
     named_type->ty_Named.type = nullptr;
     named_type->ty_Named.methods = nullptr;
     named_type->ty_Named.factory = nullptr;
@@ -279,7 +281,7 @@ AstNode* Parser::parseStructDecl(bool exported) {
     defineGlobal(symbol);
 
     auto* astruct_type = allocNode(AST_TYPE_STRUCT, SpanOver(start_span, prev.span));
-    astruct_type->an_TypeStruct.fields = ast_arena.MoveVec(std::move(fields));
+    astruct_type->an_TypeStruct.fields = ast_arena.MoveList(fields);
 
     auto* astruct = allocNode(AST_TYPEDEF, SpanOver(start_span, prev.span));
     astruct->an_TypeDef.symbol = symbol;
@@ -303,7 +305,7 @@ AstNode* Parser::parseAliasDecl(bool exported) {
     auto* alias_type = AllocType(global_arena, TYPE_ALIAS);
     alias_type->ty_Named.mod_id = src_file.parent->id;
     alias_type->ty_Named.mod_name = src_file.parent->name;
-    alias_type->ty_Named.name = global_arena.MoveStr(std::move(ident.value));
+    alias_type->ty_Named.name = InternName(ident.value);
     alias_type->ty_Named.type = nullptr;
     alias_type->ty_Named.methods = nullptr;
     alias_type->ty_Named.factory = nullptr;
@@ -335,8 +337,9 @@ AstNode* Parser::parseEnumDecl(bool exported) {
 
     want(TOK_LBRACE);
 
-    std::unordered_map<std::string_view, size_t> name_map;
-    std::vector<AstNode*> variants;
+    NameMap<size_t> name_map;
+    ScratchScope scratch;
+    ArenaList<AstNode*> variants(scratch.Get());
     do {
         auto var_name_tok = wantAndGet(TOK_IDENT);
 
@@ -346,7 +349,7 @@ AstNode* Parser::parseEnumDecl(bool exported) {
         }
         want(TOK_SEMI);
 
-        auto variant_name = global_arena.MoveStr(std::move(var_name_tok.value));
+        auto variant_name = InternName(var_name_tok.value);
         if (name_map.contains(variant_name)) {
             error(var_name_tok.span, "multiple variants named {}", variant_name);
             continue;
@@ -362,14 +365,14 @@ AstNode* Parser::parseEnumDecl(bool exported) {
             variant->an_Ident.name = variant_name;
         }
 
-        variants.push_back(variant);
+        variants.Push(variant);
     } while (!has(TOK_RBRACE));
     next();
 
     auto* named_type = AllocType(global_arena, TYPE_NAMED);
     named_type->ty_Named.mod_id = src_file.parent->id;
     named_type->ty_Named.mod_name = src_file.parent->name;
-    named_type->ty_Named.name = global_arena.MoveStr(std::move(ident.value));
+    named_type->ty_Named.name = InternName(ident.value);
     named_type->ty_Named.type = nullptr;
     named_type->ty_Named.methods = nullptr;
     named_type->ty_Named.factory = nullptr;
@@ -387,7 +390,7 @@ AstNode* Parser::parseEnumDecl(bool exported) {
     defineGlobal(symbol);
 
     auto* aenum_type = allocNode(AST_TYPE_ENUM, SpanOver(start_span, prev.span));
-    aenum_type->an_TypeEnum.variants = ast_arena.MoveVec(std::move(variants));    
+    aenum_type->an_TypeEnum.variants = ast_arena.MoveList(variants);
 
     auto* aenum = allocNode(AST_TYPEDEF, SpanOver(start_span, prev.span));
     aenum->an_TypeDef.symbol = symbol;
@@ -177,7 +177,7 @@ std::string Parser::evaluateMetaValue() {
     case TOK_STRLIT:
     case TOK_INTLIT:
         next();
-        return prev.value;
+        return std::string(prev.value);
     case TOK_BOOL:
         next();
         if (prev.value == "false")
@@ -198,7 +198,7 @@ std::string Parser::evaluateMetaValue() {
     return {};
 }
 
-std::string_view Parser::lookupMetaVar(const std::string& name) {
+std::string_view Parser::lookupMetaVar(std::string_view name) {
     if (name == "OS") {
         return GetTargetPlatform().os_name;
     } else if (name == "ARCH") {
@@ -130,7 +130,7 @@ AstNode* Parser::parseAtomExpr() {
 
             auto* node = allocNode(AST_SELECTOR, SpanOver(root->span, field_name_tok.span));
             node->an_Sel.expr = root;
-            node->an_Sel.field_name = ast_arena.MoveStr(std::move(field_name_tok.value));
+            node->an_Sel.field_name = InternName(field_name_tok.value);
             
             root = node;
         } break;
@@ -229,7 +229,8 @@ AstNode* Parser::parseStructLit(AstNode* type) {
     } else if (has(TOK_IDENT)) {
         auto* first_expr = parseExpr();
 
-        std::vector<AstNode*> field_inits;
+        ScratchScope scratch;
+        ArenaList<AstNode*> field_inits(scratch.Get());
         if (first_expr->kind == AST_IDENT && has(TOK_ASSIGN)) {
             next();
             auto* init_expr = parseExpr();
@@ -237,16 +238,16 @@ AstNode* Parser::parseStructLit(AstNode* type) {
             auto* field_init = allocNode(AST_NAMED_INIT, SpanOver(first_expr->span, init_expr->span));
             field_init->an_NamedInit.name = first_expr->an_Ident.name;
             field_init->an_NamedInit.init = init_expr;
-            field_inits.push_back(field_init);
+            field_inits.Push(field_init);
 
             if (has(TOK_COMMA)) {
                 next();
 
-                std::unordered_set<std::string_view> used_field_names;
+                std::unordered_set<std::string_view, NameHash, NameEq> used_field_names;
                 used_field_names.insert(first_expr->an_Ident.name);
                 while (true) {
                     auto ident_tok = wantAndGet(TOK_IDENT);
-                    auto field_name = ast_arena.MoveStr(std::move(ident_tok.value));
+                    auto field_name = InternName(ident_tok.value);
 
                     if (used_field_names.contains(field_name)) {
                         error(ident_tok.span, "field named {} initialized multiple times", field_name);
@@ -259,7 +260,7 @@ AstNode* Parser::parseStructLit(AstNode* type) {
                     field_init = allocNode(AST_NAMED_INIT, SpanOver(ident_tok.span, init_expr->span));
                     field_init->an_NamedInit.name = field_name;
                     field_init->an_NamedInit.init = init_expr;
-                    field_inits.emplace_back(field_init);
+                    field_inits.Push(field_init);
 
                     if (has(TOK_COMMA)) {
                         next();
@@ -271,13 +272,13 @@ AstNode* Parser::parseStructLit(AstNode* type) {
 
             want(TOK_RBRACE);
         } else {
-            field_inits.push_back(first_expr);
+            field_inits.Push(first_expr);
 
             if (has(TOK_COMMA)) {
                 next();
 
                 while (true) {
-                    field_inits.push_back(parseExpr());
+                    field_inits.Push(parseExpr());
 
                     if (has(TOK_COMMA)) {
                         next();
@@ -292,7 +293,7 @@ AstNode* Parser::parseStructLit(AstNode* type) {
 
         struct_lit = allocNode(AST_STRUCT_LIT, SpanOver(type->span, prev.span));
         struct_lit->an_StructLit.type = type;
-        struct_lit->an_StructLit.field_inits =  ast_arena.MoveVec(std::move(field_inits)); 
+        struct_lit->an_StructLit.field_inits =  ast_arena.MoveList(field_inits);
     } else {
         auto field_inits = parseExprList();
         want(TOK_RBRACE);
@@ -308,7 +309,23 @@ AstNode* Parser::parseStructLit(AstNode* type) {
 
 /* -------------------------------------------------------------------------- */
 
-bool ConvertUint(const std::string& int_str, uint64_t* value) {
+// removeDigitSeps returns num_str with its digit separators (`_`) removed.
+static std::string removeDigitSeps(std::string_view num_str) {
+    std::string digits;
+    digits.reserve(num_str.size());
+
+    for (char c : num_str) {
+        if (c != '_') {
+            digits.push_back(c);
+        }
+    }
+
+    return digits;
+}
+
+bool ConvertUint(std::string_view num_str, uint64_t* value) {
+    auto int_str = removeDigitSeps(num_str);
+
     try {
         if (int_str.starts_with("0b")) {
             *value = std::stoull(int_str.substr(2), nullptr, 2);
@@ -326,7 +343,16 @@ bool ConvertUint(const std::string& int_str, uint64_t* value) {
     }
 }
 
-static rune decodeRune(const std::string& rbytes) {
+bool ConvertFloat(std::string_view num_str, double* value) {
+    try {
+        *value = std::stod(removeDigitSeps(num_str));
+        return true;
+    } catch (std::out_of_range&) {
+        return false;
+    }
+}
+
+static rune decodeRune(std::string_view rbytes) {
     byte b1 = rbytes[0];
     if (b1 == 0xff) {
         return -1;
@@ -367,7 +393,7 @@ static rune decodeRune(const std::string& rbytes) {
     return r;
 }
 
-rune ConvertRuneLit(const std::string& rune_str) {
+rune ConvertRuneLit(std::string_view rune_str) {
     if (rune_str[0] == '\\') {
         Assert(rune_str.size() == 2, "invalid escape code in parser: wrong char count");
 
@@ -416,9 +442,7 @@ AstNode* Parser::parseAtom() {
         next();
 
         double value = 0;
-        try {
-            value = std::stod(prev.value);
-        } catch (std::out_of_range&) {
+        if (!ConvertFloat(prev.value, &value)) {
             error(prev.span, "float literal cannot be accurately represented by any float type");
         }
 
@@ -444,14 +468,14 @@ AstNode* Parser::parseAtom() {
         next();
 
         auto* astr = allocNode(AST_STRING_LIT, prev.span);
-        astr->an_String.value = global_arena.MoveStr(std::move(prev.value));
+        astr->an_String.value = global_arena.CopyStr(prev.value);
         return astr;
     } break;
     case TOK_IDENT: {
         next();
 
         auto* ident = allocNode(AST_IDENT, prev.span);
-        ident->an_Ident.name = ast_arena.MoveStr(std::move(prev.value));
+        ident->an_Ident.name = InternName(prev.value);
         return ident;
     } break;
     case TOK_NULL:
@@ -487,7 +511,7 @@ AstNode* Parser::parseAtom() {
 
             auto* asel = allocNode(AST_SELECTOR, SpanOver(adot->span, prev.span));
             asel->an_Sel.expr = adot;
-            asel->an_Sel.field_name = ast_arena.MoveStr(std::move(prev.value));
+            asel->an_Sel.field_name = InternName(prev.value);
 
             return asel;
         }
@@ -557,7 +581,7 @@ AstNode* Parser::parseArrayLit() {
     return aarray;
 }
 
-std::unordered_map<std::string, AstKind> macro_name_to_kind {
+std::unordered_map<std::string_view, AstKind> macro_name_to_kind {
     { "defined", (AstKind)0 },
     { "sizeof", AST_MACRO_SIZEOF },
     { "alignof", AST_MACRO_ALIGNOF },
@@ -591,12 +615,13 @@ AstNode* Parser::parseMacroCall() {
         return expr;
     }
 
-    std::vector<AstNode*> macro_args;
+    ScratchScope scratch;
+    ArenaList<AstNode*> macro_args(scratch.Get());
 
     switch (macro_kind) {
     case AST_MACRO_SIZEOF:
     case AST_MACRO_ALIGNOF:
-        macro_args.push_back(parseTypeLabel());
+        macro_args.Push(parseTypeLabel());
         break;
     case AST_MACRO_ATOMIC_CAS_WEAK:
         for (size_t i = 0; i < 5; i++) {
@@ -608,27 +633,27 @@ AstNode* Parser::parseMacroCall() {
                 want(TOK_COMMA);
             }   
 
-            macro_args.push_back(parseExpr());
+            macro_args.Push(parseExpr());
         }
         break;
     case AST_MACRO_ATOMIC_LOAD:
-        macro_args.push_back(parseExpr());
+        macro_args.Push(parseExpr());
 
         if (has(TOK_COMMA)) {
             next();
 
-            macro_args.push_back(parseExpr());
+            macro_args.Push(parseExpr());
         }
         break;
     case AST_MACRO_ATOMIC_STORE:
-        macro_args.push_back(parseExpr());
+        macro_args.Push(parseExpr());
         want(TOK_COMMA);
-        macro_args.push_back(parseExpr());
+        macro_args.Push(parseExpr());
 
         if (has(TOK_COMMA)) {
             next();
 
-            macro_args.push_back(parseExpr());
+            macro_args.Push(parseExpr());
         }
         break;
     }
@@ -637,6 +662,6 @@ AstNode* Parser::parseMacroCall() {
     popAllowStructLit();
 
     expr = allocNode(macro_kind, SpanOver(start_span, prev.span));
-    expr->an_Macro.args = ast_arena.MoveVec(std::move(macro_args));
+    expr->an_Macro.args = ast_arena.MoveList(macro_args);
     return expr;
 }
\ No newline at end of file
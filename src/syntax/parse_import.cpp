@@ -59,7 +59,7 @@ void Parser::parseModulePath() {
         if (imported_name_tok.value == "_") {
             src_file.anon_imports.insert(dep_id);
         } else {
-            auto imported_name = global_arena.MoveStr(std::move(imported_name_tok.value));
+            auto imported_name = InternName(imported_name_tok.value);
             src_file.import_table.emplace(imported_name, dep_id);
         }
 
@@ -75,7 +75,7 @@ void Parser::parseModulePath() {
 size_t Parser::findOrAddModuleDep(const std::vector<Token>& tok_mod_path) {
     std::vector<std::string> mod_path;
     for (auto& tok : tok_mod_path) {
-        mod_path.emplace_back(std::move(tok.value));
+        mod_path.emplace_back(tok.value);
     }
     
     bool paths_matched = true;
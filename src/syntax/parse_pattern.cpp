@@ -1,10 +1,11 @@
 #include "parser.hpp"
 
 AstNode* Parser::parseCasePattern() {
-    std::vector<AstNode*> patterns;
+    ScratchScope scratch;
+    ArenaList<AstNode*> patterns(scratch.Get());
 
     while (true) {
-        patterns.push_back(parsePattern());
+        patterns.Push(parsePattern());
 
         if (has(TOK_PIPE)) {
             next();
@@ -13,11 +14,11 @@ AstNode* Parser::parseCasePattern() {
         }
     }
 
-    if (patterns.size() == 1) {
+    if (patterns.Len() == 1) {
         return patterns[0];
     } else {
-        auto* alist = allocNode(AST_EXPR_LIST, SpanOver(patterns[0]->span, patterns.back()->span));
-        alist->an_ExprList.exprs = ast_arena.MoveVec(std::move(patterns));
+        auto* alist = allocNode(AST_EXPR_LIST, SpanOver(patterns[0]->span, patterns.Back()->span));
+        alist->an_ExprList.exprs = ast_arena.MoveList(patterns);
         return alist;
     }
 }
@@ -40,9 +41,7 @@ AstNode* Parser::parsePattern() {
         next();
 
         double value = 0;
-        try {
-            value = std::stod(prev.value);
-        } catch (std::out_of_range&) {
+        if (!ConvertFloat(prev.value, &value)) {
             error(prev.span, "float literal cannot be accurately represented by any float type");
         }
 
@@ -68,14 +67,14 @@ AstNode* Parser::parsePattern() {
         next();
 
         auto* astr = allocNode(AST_STRING_LIT, prev.span);
-        astr->an_String.value = global_arena.MoveStr(std::move(prev.value));
+        astr->an_String.value = global_arena.CopyStr(prev.value);
         return astr;
     } break;
     case TOK_IDENT: {
         next();
 
         auto* ident = allocNode(AST_IDENT, prev.span);
-        ident->an_Ident.name = ast_arena.MoveStr(std::move(prev.value));
+        ident->an_Ident.name = InternName(prev.value);
 
         if (has(TOK_DOT)) {
             next();
@@ -84,7 +83,7 @@ AstNode* Parser::parsePattern() {
 
             auto* asel = allocNode(AST_SELECTOR, SpanOver(ident->span, var_name_tok.span));
             asel->an_Sel.expr = ident;
-            asel->an_Sel.field_name = ast_arena.MoveStr(std::move(var_name_tok.value));
+            asel->an_Sel.field_name = InternName(var_name_tok.value);
             return asel;
         }
 
@@ -99,7 +98,7 @@ AstNode* Parser::parsePattern() {
 
         auto* asel = allocNode(AST_SELECTOR, SpanOver(adot->span, var_name_tok.span));
         asel->an_Sel.expr = adot;
-        asel->an_Sel.field_name = ast_arena.MoveStr(std::move(var_name_tok.value));
+        asel->an_Sel.field_name = InternName(var_name_tok.value);
         return asel;
     } break;
     }
@@ -4,9 +4,10 @@ AstNode* Parser::parseBlock() {
     auto start_span = tok.span;
     want(TOK_LBRACE);
 
-    std::vector<AstNode*> stmts;
+    ScratchScope scratch;
+    ArenaList<AstNode*> stmts(scratch.Get());
     while (!has(TOK_RBRACE)) {
-        stmts.emplace_back(parseStmt());
+        stmts.Push(parseStmt());
     }
 
 
@@ -14,7 +15,7 @@ AstNode* Parser::parseBlock() {
     want(TOK_RBRACE);
 
     AstNode* block = allocNode(AST_BLOCK, SpanOver(start_span, end_span));
-    block->an_Block.stmts = ast_arena.MoveVec(std::move(stmts));
+    block->an_Block.stmts = ast_arena.MoveList(stmts);
     return block;
 }
 
@@ -85,7 +86,8 @@ AstNode* Parser::parseStmt() {
 /* -------------------------------------------------------------------------- */
 
 AstNode* Parser::parseIfStmt() {
-    std::vector<AstCondBranch> branches;
+    ScratchScope scratch;
+    ArenaList<AstCondBranch> branches(scratch.Get());
 
     while (true) {
         next();
@@ -98,7 +100,7 @@ AstNode* Parser::parseIfStmt() {
         auto body = parseBlock();
 
         auto span = SpanOver(start_span, body->span);
-        branches.emplace_back(
+        branches.Emplace(
             span,
             cond_expr,
             body
@@ -110,9 +112,9 @@ AstNode* Parser::parseIfStmt() {
     }
 
     auto else_stmt = maybeParseElse();
-    auto span = SpanOver(branches[0].span, else_stmt != nullptr ? else_stmt->span : branches.back().span);
+    auto span = SpanOver(branches[0].span, else_stmt != nullptr ? else_stmt->span : branches.Back().span);
     auto* aif = allocNode(AST_IF, span);
-    aif->an_If.branches = ast_arena.MoveVec(std::move(branches));
+    aif->an_If.branches = ast_arena.MoveList(branches);
     aif->an_If.else_stmt = else_stmt;
     return aif;
 }
@@ -222,7 +224,8 @@ AstNode* Parser::parseMatchStmt() {
 
     want(TOK_LBRACE);
 
-    std::vector<AstCondBranch> cases;
+    ScratchScope scratch;
+    ArenaList<AstCondBranch> cases(scratch.Get());
     while (has(TOK_CASE)) {
         auto case_start_span = tok.span;
         next();
@@ -231,25 +234,30 @@ AstNode* Parser::parseMatchStmt() {
 
         want(TOK_COLON);
 
-        std::vector<AstNode*> stmts;
-        while (!has(TOK_CASE) && !has(TOK_RBRACE)) {
-            stmts.push_back(parseStmt());
-        }
-
+        // The case's statements are freed from the scratch arena before the
+        // case is added so that cases can keep growing in place.
         AstNode* case_block;
-        if (stmts.size() > 0) {
-            case_block = allocNode(AST_BLOCK, SpanOver(stmts[0]->span, stmts.back()->span));
-            case_block->an_Block.stmts = ast_arena.MoveVec(std::move(stmts));
+        {
+            ScratchScope case_scratch;
+            ArenaList<AstNode*> stmts(case_scratch.Get());
+            while (!has(TOK_CASE) && !has(TOK_RBRACE)) {
+                stmts.Push(parseStmt());
+            }
+
+            if (stmts.Len() > 0) {
+                case_block = allocNode(AST_BLOCK, SpanOver(stmts[0]->span, stmts.Back()->span));
+                case_block->an_Block.stmts = ast_arena.MoveList(stmts);
+            }
         }
         
-        cases.emplace_back(SpanOver(case_start_span, prev.span), pattern, case_block);
+        cases.Emplace(SpanOver(case_start_span, prev.span), pattern, case_block);
     }
 
     want(TOK_RBRACE);
 
     auto* amatch = allocNode(AST_MATCH, SpanOver(start_span, prev.span));
     amatch->an_Match.expr = expr;
-    amatch->an_Match.cases = ast_arena.MoveVec(std::move(cases));
+    amatch->an_Match.cases = ast_arena.MoveList(cases);
     return amatch;
 }
 
@@ -286,7 +294,7 @@ AstNode* Parser::parseLocalVarDecl() {
 
     Symbol* symbol = global_arena.New<Symbol>(
         src_file.parent->id,
-        global_arena.MoveStr(std::move(name_tok.value)),
+        InternName(name_tok.value),
         name_tok.span,
         comptime ? SYM_CONST : SYM_VAR,
         0,
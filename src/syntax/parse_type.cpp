@@ -87,7 +87,7 @@ AstNode* Parser::parseTypeLabel() {
         next();
 
         auto* aident = allocNode(AST_IDENT, prev.span);
-        aident->an_Ident.name = ast_arena.MoveStr(std::move(prev.value));
+        aident->an_Ident.name = InternName(prev.value);
         
         if (has(TOK_DOT)) {
             next();
@@ -96,7 +96,7 @@ AstNode* Parser::parseTypeLabel() {
 
             auto* asel = allocNode(AST_SELECTOR, SpanOver(aident->span, prev.span));
             asel->an_Sel.expr = aident;
-            asel->an_Sel.field_name = ast_arena.MoveStr(std::move(prev.value));
+            asel->an_Sel.field_name = InternName(prev.value);
             return asel;
         }
 
@@ -120,21 +120,22 @@ AstNode* Parser::parseStructTypeLabel() {
 
     want(TOK_LBRACE);
 
-    std::vector<AstStructField> fields;
-    std::unordered_map<std::string_view, size_t> name_map;
+    ScratchScope scratch;
+    ArenaList<AstStructField> fields(scratch.Get());
+    NameMap<size_t> name_map;
     while (true) {
         auto field_name_toks = parseIdentList();
         auto field_type = parseTypeExt();
         
         for (auto& field_name_tok : field_name_toks) {
-            auto field_name = global_arena.MoveStr(std::move(field_name_tok.value));
+            auto field_name = InternName(field_name_tok.value);
 
             if (name_map.contains(field_name)) {
                 error(field_name_tok.span, "multiple field named {}", field_name);
             }
 
-            name_map.emplace(field_name, fields.size());
-            fields.emplace_back(AstStructField{ field_name_tok.span, field_name, field_type, true });
+            name_map.emplace(field_name, fields.Len());
+            fields.Push(AstStructField{ field_name_tok.span, field_name, field_type, true });
         }
 
         if (has(TOK_COMMA)) {
@@ -146,6 +147,6 @@ AstNode* Parser::parseStructTypeLabel() {
     want(TOK_RBRACE);
 
     auto* astruct_type = allocNode(AST_TYPE_STRUCT, SpanOver(start_span, prev.span));
-    astruct_type->an_TypeStruct.fields = ast_arena.MoveVec(std::move(fields));
+    astruct_type->an_TypeStruct.fields = ast_arena.MoveList(fields);
     return astruct_type;
 }
\ No newline at end of file
@@ -67,7 +67,7 @@ void Parser::parseAttrList(AttributeMap& attr_map) {
 
 void Parser::parseAttribute(AttributeMap& attr_map) {
     auto name_tok = wantAndGet(TOK_IDENT);
-    auto name = global_arena.MoveStr(std::move(name_tok.value));
+    auto name = InternName(name_tok.value);
 
     if (has(TOK_LPAREN)) {
         next();
@@ -77,7 +77,7 @@ void Parser::parseAttribute(AttributeMap& attr_map) {
         attr_map.emplace(name, Attribute{
             name,
             name_tok.span,
-            global_arena.MoveStr(std::move(value_tok.value)),
+            global_arena.CopyStr(value_tok.value),
             value_tok.span
         });
     } else {
@@ -91,10 +91,11 @@ void Parser::parseAttribute(AttributeMap& attr_map) {
 /* -------------------------------------------------------------------------- */
 
 std::span<AstNode*> Parser::parseExprList(TokenKind delim) {
-    std::vector<AstNode*> exprs;
+    ScratchScope scratch;
+    ArenaList<AstNode*> exprs(scratch.Get());
 
     while (true) {
-        exprs.emplace_back(parseExpr());
+        exprs.Push(parseExpr());
 
         if (has(delim)) {
             next();
@@ -103,7 +104,7 @@ std::span<AstNode*> Parser::parseExprList(TokenKind delim) {
         }
     }
 
-    return ast_arena.MoveVec(std::move(exprs));
+    return ast_arena.MoveList(exprs);
 }
 
 AstNode* Parser::parseInitializer() {
@@ -160,7 +161,7 @@ void Parser::defineGlobal(Symbol* symbol) {
 /* -------------------------------------------------------------------------- */
 
 void Parser::next() {
-    prev = std::move(tok);
+    prev = tok;
     lexer.NextToken(tok);
 
     while (directives_enabled && tok.kind == TOK_DIRECTIVE) {
@@ -0,0 +1,214 @@
+#include "scan.hpp"
+
+#include <bit>
+
+#if ARCH_AMD64 || defined(__SSE2__)
+    #define SCAN_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define SCAN_SSE2 0
+#endif
+
+#if SCAN_SSE2
+
+// scanBlocks scans [p, end) 16 bytes at a time.  stop_mask computes the bit
+// mask of the bytes in a block which end the run.  This returns a pointer to
+// the first byte which ends the run or to the start of the final partial block
+// which is left for the caller to scan byte by byte.
+template<typename F>
+static inline const char* scanBlocks(const char* p, const char* end, F stop_mask) {
+    while (end - p >= 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)p);
+
+        unsigned mask = stop_mask(block);
+        if (mask != 0) {
+            return p + std::countr_zero(mask);
+        }
+
+        p += 16;
+    }
+
+    return p;
+}
+
+// byteMask returns the bit mask of the bytes of v which are all ones.  Since
+// this is just the high bit of each byte, the byte mask of a raw block is the
+// mask of its non-ASCII bytes.
+static inline unsigned byteMask(__m128i v) {
+    return (unsigned)_mm_movemask_epi8(v);
+}
+
+// eqByte compares every byte of block to c.
+static inline __m128i eqByte(__m128i block, char c) {
+    return _mm_cmpeq_epi8(block, _mm_set1_epi8(c));
+}
+
+// inRange tests whether every byte of block is between lo and hi inclusive.
+// The comparison is signed so non-ASCII bytes are never in an ASCII range.
+static inline __m128i inRange(__m128i block, char lo, char hi) {
+    return _mm_and_si128(
+        _mm_cmpgt_epi8(block, _mm_set1_epi8(lo - 1)),
+        _mm_cmplt_epi8(block, _mm_set1_epi8(hi + 1))
+    );
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+static inline bool isAsciiByte(char c) {
+    return (c & 0x80) == 0;
+}
+
+static inline bool isWhitespaceByte(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static inline bool isDecDigitByte(char c) {
+    return '0' <= c && c <= '9';
+}
+
+static inline bool isIdentByte(char c) {
+    return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || isDecDigitByte(c) || c == '_';
+}
+
+/* -------------------------------------------------------------------------- */
+
+const char* ScanWhitespace(const char* p, const char* end) {
+#if SCAN_SSE2
+    p = scanBlocks(p, end, [](__m128i block) {
+        auto ws = _mm_or_si128(
+            _mm_or_si128(eqByte(block, ' '), eqByte(block, '\t')),
+            _mm_or_si128(eqByte(block, '\r'), eqByte(block, '\n'))
+        );
+
+        return ~byteMask(ws) & 0xffff;
+    });
+#endif
+
+    while (p < end && isWhitespaceByte(*p)) {
+        p++;
+    }
+
+    return p;
+}
+
+const char* ScanIdent(const char* p, const char* end) {
+#if SCAN_SSE2
+    p = scanBlocks(p, end, [](__m128i block) {
+        auto ident = _mm_or_si128(
+            _mm_or_si128(inRange(block, 'a', 'z'), inRange(block, 'A', 'Z')),
+            _mm_or_si128(inRange(block, '0', '9'), eqByte(block, '_'))
+        );
+
+        return ~byteMask(ident) & 0xffff;
+    });
+#endif
+
+    while (p < end && isIdentByte(*p)) {
+        p++;
+    }
+
+    return p;
+}
+
+const char* ScanDecDigits(const char* p, const char* end) {
+#if SCAN_SSE2
+    p = scanBlocks(p, end, [](__m128i block) {
+        return ~byteMask(inRange(block, '0', '9')) & 0xffff;
+    });
+#endif
+
+    while (p < end && isDecDigitByte(*p)) {
+        p++;
+    }
+
+    return p;
+}
+
+const char* ScanStrChars(const char* p, const char* end) {
+#if SCAN_SSE2
+    p = scanBlocks(p, end, [](__m128i block) {
+        auto special = _mm_or_si128(
+            _mm_or_si128(eqByte(block, '"'), eqByte(block, '\\')),
+            eqByte(block, '\n')
+        );
+
+        return byteMask(special) | byteMask(block);
+    });
+#endif
+
+    while (p < end && isAsciiByte(*p) && *p != '"' && *p != '\\' && *p != '\n') {
+        p++;
+    }
+
+    return p;
+}
+
+const char* ScanLineComment(const char* p, const char* end) {
+#if SCAN_SSE2
+    p = scanBlocks(p, end, [](__m128i block) {
+        return byteMask(eqByte(block, '\n')) | byteMask(block);
+    });
+#endif
+
+    while (p < end && isAsciiByte(*p) && *p != '\n') {
+        p++;
+    }
+
+    return p;
+}
+
+const char* ScanBlockComment(const char* p, const char* end) {
+#if SCAN_SSE2
+    p = scanBlocks(p, end, [](__m128i block) {
+        return byteMask(eqByte(block, '*')) | byteMask(block);
+    });
+#endif
+
+    while (p < end && isAsciiByte(*p) && *p != '*') {
+        p++;
+    }
+
+    return p;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void AdvanceTextPos(const char* p, const char* end, size_t& line, size_t& col) {
+#if SCAN_SSE2
+    while (end - p >= 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)p);
+
+        unsigned newlines = byteMask(eqByte(block, '\n'));
+        unsigned tabs = byteMask(eqByte(block, '\t'));
+
+        if (newlines == 0) {
+            col += 16 + 3 * std::popcount(tabs);
+        } else {
+            // Only the bytes after the last newline count towards the column.
+            int last_newline = 31 - std::countl_zero(newlines);
+
+            line += std::popcount(newlines);
+            col = 1 + (15 - last_newline) + 3 * std::popcount(tabs >> (last_newline + 1));
+        }
+
+        p += 16;
+    }
+#endif
+
+    for (; p < end; p++) {
+        switch (*p) {
+        case '\n':
+            line++;
+            col = 1;
+            break;
+        case '\t':
+            col += 4;
+            break;
+        default:
+            col++;
+            break;
+        }
+    }
+}
@@ -1,6 +1,6 @@
 #include "target.hpp"
 
-#include "llvm/IR/Type.h"
+#include <algorithm>
 
 static TargetPlatform target_platform;
 
@@ -11,56 +11,96 @@ TargetPlatform& GetTargetPlatform() {
 /* -------------------------------------------------------------------------- */
 
 uint64_t TargetPlatform::GetComptimeSizeOf(Type* type) {
-    return ll_layout->getTypeAllocSize(getLLVMType(type));
+    return getLayout(type).size;
 }
 
 uint64_t TargetPlatform::GetComptimeAlignOf(Type* type) {
-    return ll_layout->getPrefTypeAlign(getLLVMType(type)).value();
+    return getLayout(type).pref_align;
+}
+
+void TargetPlatform::InitLayoutModel() {
+    ptr_size = arch_size / 8;
+
+    if (arch_size == 64) {
+        i64_abi_align = 8;
+        f64_abi_align = 8;
+        aggregate_pref_align = 8;
+    } else if (ll_triple.isOSWindows()) {
+        // 32-bit Windows aligns 64-bit scalars naturally but only prefers
+        // 4-byte alignment for aggregates.
+        i64_abi_align = 8;
+        f64_abi_align = 8;
+        aggregate_pref_align = 4;
+    } else {
+        // The 32-bit System V ABI only aligns 64-bit scalars to 4 bytes.
+        i64_abi_align = 4;
+        f64_abi_align = 4;
+        aggregate_pref_align = 8;
+    }
 }
 
 /* -------------------------------------------------------------------------- */
 
-llvm::Type* TargetPlatform::getLLVMType(Type* type) {
+TypeLayout TargetPlatform::getLayout(Type* type) {
     type = type->FullUnwrap();
 
     switch (type->kind) {
     case TYPE_INT:
-        return llvm::IntegerType::get(ll_context, type->ty_Int.bit_size);
+        if (type->ty_Int.bit_size == 64) {
+            return getScalarLayout(8, i64_abi_align);
+        }
+
+        return getScalarLayout(type->ty_Int.bit_size / 8, type->ty_Int.bit_size / 8);
     case TYPE_FLOAT:
         if (type->ty_Float.bit_size == 64) {
-            return llvm::Type::getDoubleTy(ll_context);
-        } else {
-            return llvm::Type::getFloatTy(ll_context);
+            return getScalarLayout(8, f64_abi_align);
         }
-        break;
+
+        return getScalarLayout(4, 4);
     case TYPE_BOOL:
     case TYPE_UNIT:
-        return llvm::Type::getInt1Ty(ll_context);
+        // Both are represented as i1.
+        return getScalarLayout(1, 1);
     case TYPE_PTR:
     case TYPE_FUNC:
-        return llvm::PointerType::get(ll_context, 0);
+        return getScalarLayout(ptr_size, ptr_size);
     case TYPE_ARRAY: {
-        auto* ll_elem_type = getLLVMType(type->ty_Array.elem_type);
-        return llvm::ArrayType::get(ll_elem_type, type->ty_Array.len);
+        auto elem_layout = getLayout(type->ty_Array.elem_type);
+        return { 
+            elem_layout.size * type->ty_Array.len, 
+            elem_layout.abi_align, 
+            elem_layout.pref_align 
+        };
     } break;
     case TYPE_SLICE:
-    case TYPE_STRING:
-        return llvm::StructType::get(ll_context, { 
-            llvm::PointerType::get(ll_context, 0),
-            getLLVMType(platform_int_type)   
-        });
+    case TYPE_STRING: {
+        // Slices are a struct of a pointer and a platform int: both have the
+        // size and alignment of a pointer.
+        return { 2 * ptr_size, ptr_size, std::max(ptr_size, aggregate_pref_align) };
+    } break;
     case TYPE_STRUCT: {
-        std::vector<llvm::Type*> ll_field_types;
+        uint64_t offset = 0;
+        uint64_t abi_align = 1;
         for (auto& field : type->ty_Struct.fields) {
-            ll_field_types.push_back(getLLVMType(field.type));
+            auto field_layout = getLayout(field.type);
+
+            offset = (offset + field_layout.abi_align - 1) / field_layout.abi_align * field_layout.abi_align;
+            offset += field_layout.size;
+            abi_align = std::max(abi_align, field_layout.abi_align);
         }
 
-        return llvm::StructType::get(ll_context, ll_field_types);
+        uint64_t size = (offset + abi_align - 1) / abi_align * abi_align;
+        return { size, abi_align, std::max(abi_align, aggregate_pref_align) };
     } break;
     case TYPE_ENUM:
-        return getLLVMType(platform_int_type);
+        return getLayout(platform_int_type);
     default:
         Panic("cannot compute size or align of non-concrete type");
         break;
     }
-}
\ No newline at end of file
+}
+
+TypeLayout TargetPlatform::getScalarLayout(uint64_t size, uint64_t abi_align) {
+    // Scalars always prefer to be naturally aligned.
+    return { size, abi_align, size };
+}
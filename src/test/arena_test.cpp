@@ -115,10 +115,60 @@ void testArenaMoveTo() {
     }
 }
 
+void testArenaRewind() {
+    printf("\nRewind:\n\n");
+
+    Arena arena;
+    arena.Alloc(16);
+
+    auto mark = arena.Mark();
+    char* first = (char*)arena.Alloc(ARENA_BIG_ALLOC_SIZE);
+    arena.Rewind(mark);
+
+    char* second = (char*)arena.Alloc(ARENA_BIG_ALLOC_SIZE);
+    printf("reused = %s\n", first == second ? "true" : "false");
+    printf("requested = %zu\n", arena.GetStats().n_requested);
+}
+
+void testArenaList() {
+    printf("\nArena List:\n\n");
+
+    ScratchScope scratch;
+
+    // The inner lists are freed at the end of each scope so the outer list
+    // can keep growing in place.
+    ArenaList<size_t> outer(scratch.Get());
+    for (int i = 0; i < 10; i++) {
+        size_t inner_len;
+        {
+            ScratchScope inner_scratch;
+
+            ArenaList<int> inner(inner_scratch.Get());
+            for (int j = 0; j <= i; j++) {
+                inner.Push(j);
+            }
+
+            inner_len = inner.Len();
+        }
+
+        outer.Push(inner_len * 10);
+    }
+
+    Arena arena;
+    auto items = arena.MoveList(outer);
+
+    printf("list len = %zu\n", outer.Len());
+    for (auto& item : items) {
+        printf("%zu\n", item);
+    }
+}
+
 void testArenaAll() {
     testArenaBasicAlloc();
     testArenaManyAlloc();
     testArenaBigAlloc();
     testArenaConstruct();
     testArenaMoveTo();
+    testArenaRewind();
+    testArenaList();
 }
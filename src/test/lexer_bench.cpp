@@ -0,0 +1,193 @@
+#include <chrono>
+
+#include "lexer.hpp"
+
+using BenchClock = std::chrono::steady_clock;
+
+// elapsedNs returns the number of nanoseconds since start.
+static double elapsedNs(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+}
+
+// genBenchSource generates n_funcs functions of typical looking Berry code.
+static std::string genBenchSource(int n_funcs) {
+    std::string src = "module bench;\n\n";
+
+    for (int i = 0; i < n_funcs; i++) {
+        src += std::format(
+            "// compute_{0} computes a value for the benchmark.\n"
+            "func compute_{0}(alpha: i64, beta_value: i64) i64 {{\n"
+            "\tlet result = alpha * {0} + beta_value / 3;\n"
+            "\tif result > 1_000 && alpha != beta_value {{\n"
+            "\t\treturn result - 0x7f;\n"
+            "\t}}\n"
+            "\n"
+            "\t/* Strings and floats are lexed too. */\n"
+            "\tlet message: string = \"result number {0}\\n\";\n"
+            "\treturn result + (message.len as i64) * 2.5e3 as i64;\n"
+            "}}\n\n",
+            i
+        );
+    }
+
+    return src;
+}
+
+// lexAll lexes src into toks.
+static void lexAll(std::string_view src, std::vector<Token>& toks) {
+    SourceFile src_file { nullptr, 0, "bench.bry", "bench.bry" };
+    Lexer lexer(src, src_file);
+
+    Token tok;
+    do {
+        lexer.NextToken(tok);
+        toks.push_back(tok);
+    } while (tok.kind != TOK_EOF);
+}
+
+/* -------------------------------------------------------------------------- */
+
+// hashed_keywords is the keyword table the lexer used before it used a perfect
+// hash table.  It is the baseline for benchKeywordLookup.
+static std::unordered_map<std::string_view, TokenKind> hashed_keywords {
+    { "let", TOK_LET },
+    { "const", TOK_CONST },
+    { "func", TOK_FUNC },
+    { "struct", TOK_STRUCT },
+    { "enum", TOK_ENUM },
+    { "type", TOK_TYPE },
+    { "factory", TOK_FACTORY },
+    { "if", TOK_IF },
+    { "elif", TOK_ELIF },
+    { "else", TOK_ELSE },
+    { "while", TOK_WHILE },
+    { "for", TOK_FOR },
+    { "do", TOK_DO },
+    { "match", TOK_MATCH },
+    { "case", TOK_CASE },
+    { "unsafe", TOK_UNSAFE },
+    { "break", TOK_BREAK },
+    { "continue", TOK_CONTINUE },
+    { "return", TOK_RETURN },
+    { "fallthrough", TOK_FALLTHROUGH },
+    { "new", TOK_NEW },
+    { "as", TOK_AS },
+    { "null", TOK_NULL },
+    { "i8", TOK_I8 },
+    { "u8", TOK_U8 },
+    { "i16", TOK_I16 },
+    { "u16", TOK_U16 },
+    { "i32", TOK_I32 },
+    { "u32", TOK_U32 },
+    { "i64", TOK_I64 },
+    { "u64", TOK_U64 },
+    { "f32", TOK_F32 },
+    { "f64", TOK_F64 },
+    { "bool", TOK_BOOL },
+    { "unit", TOK_UNIT },
+    { "string", TOK_STRING },
+    { "module", TOK_MODULE },
+    { "import", TOK_IMPORT },
+    { "pub", TOK_PUB },
+    { "true", TOK_BOOLLIT },
+    { "false", TOK_BOOLLIT }
+};
+
+#define N_LOOKUP_ROUNDS 200
+
+void benchKeywordLookup() {
+    printf("\nKeyword Lookup:\n\n");
+
+    // The words looked up are the identifiers and keywords of generated code
+    // so that the mix of hits and misses is realistic.
+    auto src = genBenchSource(1000);
+    std::vector<Token> toks;
+    lexAll(src, toks);
+
+    std::vector<std::string_view> words;
+    for (auto& tok : toks) {
+        if (tok.kind == TOK_IDENT || KeywordKind(tok.value) != TOK_IDENT) {
+            words.push_back(tok.value);
+        }
+    }
+
+    for (auto& pair : hashed_keywords) {
+        words.push_back(pair.first);
+    }
+
+    size_t n_mismatched = 0;
+    for (auto word : words) {
+        auto it = hashed_keywords.find(word);
+        auto expected = it == hashed_keywords.end() ? TOK_IDENT : it->second;
+
+        if (KeywordKind(word) != expected) {
+            printf("mismatch: %.*s\n", (int)word.size(), word.data());
+            n_mismatched++;
+        }
+    }
+
+    // The kinds are summed so the lookups can't be optimized away.
+    size_t hashed_sum = 0;
+    auto start = BenchClock::now();
+    for (int i = 0; i < N_LOOKUP_ROUNDS; i++) {
+        for (auto word : words) {
+            auto it = hashed_keywords.find(word);
+            hashed_sum += it == hashed_keywords.end() ? TOK_IDENT : it->second;
+        }
+    }
+    double hashed_ns = elapsedNs(start);
+
+    size_t perfect_sum = 0;
+    start = BenchClock::now();
+    for (int i = 0; i < N_LOOKUP_ROUNDS; i++) {
+        for (auto word : words) {
+            perfect_sum += KeywordKind(word);
+        }
+    }
+    double perfect_ns = elapsedNs(start);
+
+    double n_lookups = (double)words.size() * N_LOOKUP_ROUNDS;
+    printf("words = %zu, mismatched = %zu\n", words.size(), n_mismatched);
+    printf("hash map     = %.2f ns/lookup\n", hashed_ns / n_lookups);
+    printf("perfect hash = %.2f ns/lookup\n", perfect_ns / n_lookups);
+    printf("sums match = %s\n", hashed_sum == perfect_sum ? "true" : "false");
+}
+
+#define N_LEX_FUNCS 100000
+#define N_LEX_ROUNDS 5
+
+void benchLexerThroughput() {
+    printf("\nLexer Throughput:\n\n");
+
+    auto src = genBenchSource(N_LEX_FUNCS);
+    SourceFile src_file { nullptr, 0, "bench.bry", "bench.bry" };
+
+    // The best round is reported to filter out noise.
+    size_t n_tokens = 0;
+    double best_ns = 0;
+    for (int i = 0; i < N_LEX_ROUNDS; i++) {
+        auto start = BenchClock::now();
+
+        Lexer lexer(src, src_file);
+        Token tok;
+
+        n_tokens = 0;
+        do {
+            lexer.NextToken(tok);
+            n_tokens++;
+        } while (tok.kind != TOK_EOF);
+
+        double ns = elapsedNs(start);
+        if (i == 0 || ns < best_ns) {
+            best_ns = ns;
+        }
+    }
+
+    printf("source = %.2f MB, tokens = %zu\n", src.size() / 1e6, n_tokens);
+    printf("throughput = %.1f MB/s, %.1f Mtokens/s\n", src.size() / best_ns * 1e3, n_tokens / best_ns * 1e3);
+}
+
+void benchLexerAll() {
+    benchKeywordLookup();
+    benchLexerThroughput();
+}
\ No newline at end of file
@@ -0,0 +1,6 @@
+#ifndef LEXER_BENCH_H_INC
+#define LEXER_BENCH_H_INC
+
+void benchLexerAll();
+
+#endif
@@ -0,0 +1,62 @@
+#include "thread_pool.hpp"
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+
+size_t GetDefaultWorkerCount() {
+    // hardware_concurrency is allowed to return 0 if it can't figure out how
+    // many threads the machine has.
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void ParallelFor(size_t n_workers, size_t n_items, const ParallelTask& task) {
+    if (n_items == 0) {
+        return;
+    }
+
+    n_workers = std::clamp(n_workers, (size_t)1, n_items);
+
+    std::atomic<size_t> next_item { 0 };
+    std::atomic<bool> failed { false };
+
+    std::mutex error_mutex;
+    std::exception_ptr first_error { nullptr };
+
+    auto run_worker = [&](size_t worker_id) {
+        while (!failed.load(std::memory_order_relaxed)) {
+            size_t item = next_item.fetch_add(1, std::memory_order_relaxed);
+            if (item >= n_items) {
+                break;
+            }
+
+            try {
+                task(worker_id, item);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!first_error) {
+                    first_error = std::current_exception();
+                }
+
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(n_workers - 1);
+    for (size_t i = 1; i < n_workers; i++) {
+        workers.emplace_back(run_worker, i);
+    }
+
+    run_worker(0);
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    if (first_error) {
+        std::rethrow_exception(first_error);
+    }
+}
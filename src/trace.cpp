@@ -0,0 +1,168 @@
+#include "trace.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+
+using Clock = std::chrono::steady_clock;
+
+bool trace_enabled = false;
+
+// TraceEvent is a completed span.  Times are in microseconds since the trace
+// was started.
+struct TraceEvent {
+    std::string name;
+    std::string detail;
+    uint64_t start_us;
+    uint64_t dur_us;
+};
+
+// OpenSpan is a span which has been begun but not yet ended.
+struct OpenSpan {
+    std::string name;
+    std::string detail;
+    uint64_t start_us;
+    uint64_t min_dur_us;
+};
+
+// TraceThread stores the spans recorded by a single thread.  Each thread
+// records into its own buffer so that no locking is needed except when a
+// thread records its first span.
+struct TraceThread {
+    uint64_t tid;
+    std::vector<TraceEvent> events;
+    std::vector<OpenSpan> open_spans;
+};
+
+// trace_threads holds the buffers of all the threads which have recorded
+// spans since the trace was started.
+static std::vector<std::unique_ptr<TraceThread>> trace_threads;
+static std::mutex trace_threads_mutex;
+
+static Clock::time_point trace_start;
+
+// trace_gen is incremented every time the trace is started so that threads
+// don't keep using their buffers from a previous trace.
+static uint64_t trace_gen = 0;
+
+static thread_local TraceThread* curr_thread = nullptr;
+static thread_local uint64_t curr_thread_gen = 0;
+
+// getTraceThread returns the trace buffer of the current thread.
+static TraceThread& getTraceThread() {
+    if (curr_thread == nullptr || curr_thread_gen != trace_gen) {
+        std::lock_guard<std::mutex> lock(trace_threads_mutex);
+
+        auto& thread = trace_threads.emplace_back(std::make_unique<TraceThread>());
+        thread->tid = trace_threads.size();
+
+        curr_thread = thread.get();
+        curr_thread_gen = trace_gen;
+    }
+
+    return *curr_thread;
+}
+
+// traceNow returns the current time in microseconds since the trace started.
+static uint64_t traceNow() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - trace_start).count();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void StartTrace() {
+    trace_threads.clear();
+    trace_gen++;
+    trace_start = Clock::now();
+    trace_enabled = true;
+}
+
+void BeginTraceSpan(std::string_view name, std::string_view detail, uint64_t min_dur_us) {
+    auto& thread = getTraceThread();
+    thread.open_spans.emplace_back(std::string(name), std::string(detail), traceNow(), min_dur_us);
+}
+
+void EndTraceSpan() {
+    auto& thread = getTraceThread();
+    Assert(thread.open_spans.size() > 0, "ended a trace span with no open spans");
+
+    auto& span = thread.open_spans.back();
+    auto dur_us = traceNow() - span.start_us;
+    if (dur_us >= span.min_dur_us) {
+        thread.events.emplace_back(std::move(span.name), std::move(span.detail), span.start_us, dur_us);
+    }
+
+    thread.open_spans.pop_back();
+}
+
+/* -------------------------------------------------------------------------- */
+
+// writeJsonStr writes str to out as a quoted JSON string.
+static void writeJsonStr(std::ofstream& out, std::string_view str) {
+    out << '"';
+
+    for (char c : str) {
+        switch (c) {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        case '\n':
+            out << "\\n";
+            break;
+        case '\t':
+            out << "\\t";
+            break;
+        default:
+            if ((byte)c < 0x20) {
+                out << std::format("\\u{:04x}", (int)c);
+            } else {
+                out << c;
+            }
+            break;
+        }
+    }
+
+    out << '"';
+}
+
+void FinishTrace(const std::string& out_path) {
+    trace_enabled = false;
+
+    std::ofstream out(out_path);
+    if (!out) {
+        ReportError("opening trace file: {}", out_path);
+        return;
+    }
+
+    out << "{\"traceEvents\":[";
+
+    bool first = true;
+    for (auto& thread : trace_threads) {
+        // Spans which were never ended (because of an error) are dropped.
+        for (auto& event : thread->events) {
+            if (!first) {
+                out << ",";
+            }
+            first = false;
+
+            out << "\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->tid;
+            out << ",\"ts\":" << event.start_us << ",\"dur\":" << event.dur_us;
+            out << ",\"name\":";
+            writeJsonStr(out, event.name);
+
+            if (!event.detail.empty()) {
+                out << ",\"args\":{\"detail\":";
+                writeJsonStr(out, event.detail);
+                out << "}";
+            }
+
+            out << "}";
+        }
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    trace_threads.clear();
+}
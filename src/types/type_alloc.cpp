@@ -1,6 +1,7 @@
 #include "types.hpp"
 
 #include "arena.hpp"
+#include "stats.hpp"
 
 static size_t type_variant_sizes[TYPES_COUNT] = {
     sizeof(prim_i8_type.ty_Int),    
@@ -27,6 +28,8 @@ Type* AllocType(Arena& arena, TypeKind kind) {
     size_t var_size = type_variant_sizes[(int)kind];
     size_t full_size = sizeof(Type) - LARGEST_TYPE_VARIANT_SIZE + var_size;
 
+    CountType(kind);
+
     auto* type = (Type*)arena.Alloc(full_size);
     type->kind = kind;
     return type;